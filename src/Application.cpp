@@ -3,6 +3,7 @@
 #include <spdlog/spdlog.h>
 
 #include "Serialization.h"
+#include "PrefabTemplate.h"
 #include "ECS/components/CameraController.h"
 #include "Random.h"
 #include <glm/gtc/type_ptr.hpp>
@@ -26,6 +27,10 @@ Application::Application()
 
 Application::~Application()
 {
+	// zasoby GPU zwalniamy, póki kontekst jeszcze istnieje
+	scene = nullptr;
+	renderer = nullptr;
+
 	glfwDestroyWindow(window);
 	glfwTerminate();
 
@@ -199,9 +204,18 @@ bool Application::init()
 	models.emplace_back(new Model("res/models/woda.fbx"));
 	models.emplace_back(new Model("res/models/GABKA.fbx"));
 
+	renderer = std::make_unique<Renderer>();
+
+	// prefaby kompilowane po wczytaniu shaderów i modeli - komponenty trzymają do nich wskaźniki
+	for (const auto& [prefabName, prefabJson] : prefabs)
+	{
+		compilePrefab(prefabName);
+	}
+
 	scene = std::make_shared<Scene>(this);
 	Serialization::loadScene("res/scenes/demo.scene.json", *scene, {shaders, models, true});
 	setupEvents();
+	setupSystems();
 	scene->getTransformSystem().update();
 	scene->getRenderingSystem().buildTree();
 #ifndef EDITOR_APP
@@ -264,379 +278,410 @@ void Application::update()
 {
 	scene->getRenderingSystem().updatePreviousModelMatrices();
 
-	auto transforms = scene->getStorage<Transform>();
-	auto velocityComponents = scene->getStorage<VelocityComponent>();
+	systemScheduler.run(*scene);
+}
 
-	if (velocityComponents != nullptr)
-	{
-		for (int i = 0; i < velocityComponents->getQuantity(); i++)
+// Kolejność rejestracji to kolejność wykonania systemów, które ze sobą kolidują.
+// Transform zapisuje tylko TransformUpdate (i systemy exclusive) - pozostałe systemy czytają Transform
+// i wrzucają zmiany do własnej TransformWriteQueue, stosowanej w TransformSystem::update().
+void Application::setupSystems()
+{
+	// indeks kolejki zapisów systemu - kolejka pobierana przy każdym uruchomieniu z bieżącej sceny,
+	// bo loadScene i edytor podmieniają scenę bez ponownej rejestracji systemów
+	uint32_t nextWriteQueue = 0;
+
+	systemScheduler.addSystem({
+		.name = "Velocity",
+		.access = SystemAccess().read<Transform, TransformInfoComponent>().write<VelocityComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
 		{
-			auto& velocityComponent = velocityComponents->components[i];
-			auto& transform = transforms->get(velocityComponent.id);
-			if (transform.isStatic)
-				continue;
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			scene->view<VelocityComponent, Transform, TransformInfoComponent>().each([&](EntityID id, VelocityComponent& velocityComponent,
+				const Transform& transform, const TransformInfoComponent& transformInfo)
+				{
+					if (transform.isStatic || !transform.isActive)
+						return;
 
-			if (velocityComponent.useGravity)
-			{
-				velocityComponent.velocity.y -= 9.81f * deltaTime;
-			}
+					if (velocityComponent.useGravity)
+					{
+						velocityComponent.velocity.y -= 9.81f * deltaTime;
+					}
 
-			glm::vec3 newTranslation = transform.translation + velocityComponent.velocity * deltaTime;
-			scene->getTransformSystem().translateEntity(velocityComponent.id, newTranslation);
-			glm::vec3 newRotation = transform.eulerRotation + velocityComponent.angularVelocity * deltaTime;
-			scene->getTransformSystem().rotateEntity(velocityComponent.id, newRotation);
-		}
-	}
+					transformWrites.translate(id, transform.translation + velocityComponent.velocity * deltaTime);
+					transformWrites.rotate(id, transformInfo.eulerRotation + velocityComponent.angularVelocity * deltaTime);
+				});
+		},
+	});
 
-	auto butterControllers = scene->getStorage<ButterController>();
-	if (butterControllers != nullptr)
-	{
-		for (int i = 0; i < butterControllers->getQuantity(); i++)
+	systemScheduler.addSystem({
+		.name = "ButterController",
+		.access = SystemAccess().read<Transform, ButterHealthComponent>().write<ButterController, VelocityComponent, ColliderComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
 		{
-			auto& butterController = butterControllers->components[i];
-			butterController.update(window, scene.get(), deltaTime);
-		}
-	}
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			scene->view<ButterController>().each([&](EntityID id, ButterController& butterController)
+				{
+					if (!scene->isActive(id))
+						return;
+					butterController.update(window, scene.get(), deltaTime, transformWrites);
+				});
+		},
+		.mainThread = true,
+	});
 
-	auto breadControllers = scene->getStorage<BreadController>();
-	if (breadControllers != nullptr)
-	{
-		for (int i = 0; i < breadControllers->getQuantity(); i++)
+	systemScheduler.addSystem({
+		.name = "BreadController",
+		.access = SystemAccess().read<Transform>().write<BreadController, VelocityComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
 		{
-			auto& breadController = breadControllers->components[i];
-			breadController.update(window, scene.get(), deltaTime);
-		}
-	}
-
-	auto& ts = scene->getTransformSystem();
-	ts.update();
-
-	auto& cs = scene->getCollisionSystem();
-	cs.CheckCollisions();
-
-	auto& collisions = cs.GetCollisions();
-
-	bool updateScene = false;
-
-	for (const CollisionEvent& collision : collisions)
-	{
-		auto& transformA = scene->getComponent<Transform>(collision.objectA);
-		auto& transformB = scene->getComponent<Transform>(collision.objectB);
-
-		auto& colliderA = scene->getComponent<ColliderComponent>(collision.objectA);
-		auto& colliderB = scene->getComponent<ColliderComponent>(collision.objectB);
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			scene->view<BreadController>().each([&](EntityID id, BreadController& breadController)
+				{
+					if (!scene->isActive(id))
+						return;
+					breadController.update(window, scene.get(), deltaTime, transformWrites);
+				});
+		},
+		.mainThread = true,
+	});
 
-		if (colliderA.isStatic && colliderB.isStatic)
+	systemScheduler.addSystem({
+		.name = "CommandBufferPlayback",
+		.update = [this]()
 		{
-			continue;
-		}
+			// punkt synchronizacji - zmiany struktury zapisane przez kontrolery
+			scene->getCommandBuffer().playback();
+		},
+		.exclusive = true,
+	});
 
-		updateScene = true;
-		glm::vec3 separationVector = collision.separationVector;
-		if (!colliderA.isStatic && !colliderB.isStatic)
+	systemScheduler.addSystem({
+		.name = "TransformUpdate",
+		// kolejki zapisują też TransformInfoComponent::eulerRotation
+		.access = SystemAccess().write<Transform, TransformInfoComponent>(),
+		.update = [this]()
 		{
-			separationVector /= 2.0f;
-		}
+			scene->getTransformSystem().update();
+		},
+	});
 
-		if (!colliderA.isStatic)
+	systemScheduler.addSystem({
+		.name = "Collision",
+		.update = [this]()
 		{
-			glm::mat4 newMatrix = transformA.globalMatrix;
-			newMatrix[3] += glm::vec4(separationVector, 0.0f);
-			ts.setGlobalMatrix(collision.objectA, newMatrix);
-		}
+			auto& ts = scene->getTransformSystem();
+			auto& cs = scene->getCollisionSystem();
+			cs.CheckCollisions();
 
-		if (!colliderB.isStatic)
-		{
-			glm::mat4 newMatrix = transformB.globalMatrix;
-			newMatrix[3] -= glm::vec4(separationVector, 0.0f);
-			ts.setGlobalMatrix(collision.objectB, newMatrix);
-		}
-	}
+			auto& collisions = cs.GetCollisions();
 
-	if (updateScene)
-		ts.update();
+			bool updateScene = false;
+			// odczyty przez const - nie oznaczają komponentów jako zmienionych
+			const Scene& constScene = *scene;
 
-	std::unordered_set<EntityID> pressedButtons;
-	auto isPlayer = [&](EntityID id) {
-		return scene->hasComponent<ButterController>(id) ||
-			scene->hasComponent<BreadController>(id);
-		};
-	auto isButton = [&](EntityID id) {
-		return scene->hasComponent<ButtonComponent>(id);
-		};
-	for (auto& col : collisions) {
-		if ((isPlayer(col.objectA) && isButton(col.objectB)) ||
-			(isPlayer(col.objectB) && isButton(col.objectA)))
-		{
-			bool isEntAButton = isButton(col.objectA);
-			EntityID btn = isEntAButton ? col.objectA : col.objectB;
-			EntityID playerId = !isEntAButton ? col.objectA : col.objectB;
+			for (const CollisionEvent& collision : collisions)
+			{
+				auto& transformA = constScene.getComponent<Transform>(collision.objectA);
+				auto& transformB = constScene.getComponent<Transform>(collision.objectB);
 
-			auto& button = scene->getComponent<ButtonComponent>(btn);
+				auto& colliderA = constScene.getComponent<ColliderComponent>(collision.objectA);
+				auto& colliderB = constScene.getComponent<ColliderComponent>(collision.objectB);
 
-			if (!button.playerTag.empty())
-			{
-				auto& playerInfo = scene->getComponent<ObjectInfoComponent>(playerId);
-				if (playerInfo.tag != button.playerTag) {
+				if (colliderA.isStatic && colliderB.isStatic)
+				{
 					continue;
 				}
-			}
-			if (abs(col.separationVector.x) < 0.001f && abs(col.separationVector.z) < 0.001f)
-			{
-				pressedButtons.insert(btn);
-			}
-		}
-	}
-
-
-	if (auto buttons = scene->getStorage<ButtonComponent>()) {
-		for (int i = 0; i < buttons->getQuantity(); ++i) {
-			auto& btn = buttons->components[i];
-			if (btn.elevatorEntity == (EntityID)-1) continue;
-			auto& e = scene->getComponent<ElevatorComponent>(btn.elevatorEntity);
 
-			bool nowPressed = pressedButtons.count(btn.id) > 0;
-
-			if (e.isDoor) {
-
-				if (e.locked) {
-
-					if (nowPressed && e.state == ElevatorState::Closed) {
-						e.state = ElevatorState::Opening;
-						e.isMoving = true;
-					}
-					else if (nowPressed && e.state == ElevatorState::Open) {
-						e.state = ElevatorState::Closing;
-						e.isMoving = true;
-					}
+				updateScene = true;
+				glm::vec3 separationVector = collision.separationVector;
+				if (!colliderA.isStatic && !colliderB.isStatic)
+				{
+					separationVector /= 2.0f;
 				}
-				else {
 
-					if (nowPressed && e.state != ElevatorState::Opening && e.state != ElevatorState::Open) {
-						e.state = ElevatorState::Opening;
-						e.isMoving = true;
-					}
-					else if (!nowPressed && e.state != ElevatorState::Closing && e.state != ElevatorState::Closed) {
-						e.state = ElevatorState::Closing;
-						e.isMoving = true;
-					}
+				if (!colliderA.isStatic)
+				{
+					glm::mat4 newMatrix = transformA.globalMatrix;
+					newMatrix[3] += glm::vec4(separationVector, 0.0f);
+					ts.setGlobalMatrix(collision.objectA, newMatrix);
 				}
-			}
-			else {
 
-				if (nowPressed && e.state != ElevatorState::Opening && e.state != ElevatorState::Open) {
-					e.state = ElevatorState::Opening;
-					e.isMoving = true;
-				}
-				else if (!nowPressed && e.state != ElevatorState::Closing && e.state != ElevatorState::Closed) {
-					e.state = ElevatorState::Closing;
-					e.isMoving = true;
+				if (!colliderB.isStatic)
+				{
+					glm::mat4 newMatrix = transformB.globalMatrix;
+					newMatrix[3] -= glm::vec4(separationVector, 0.0f);
+					ts.setGlobalMatrix(collision.objectB, newMatrix);
 				}
 			}
-		}
-	}
-
-	if (auto elevs = scene->getStorage<ElevatorComponent>()) {
-		for (int i = 0; i < elevs->getQuantity(); ++i) {
-			auto& e = elevs->components[i];
-			if (!e.isMoving) continue;
-
-			auto& tr = scene->getComponent<Transform>(e.id);
-
-
-			if (!e.hasInitClosedPos) {
-				e.closedPos = tr.translation;
-				e.hasInitClosedPos = true;
-			}
 
-			float delta = e.speed * deltaTime;
+			if (updateScene)
+				ts.update();
+		},
+		.exclusive = true,
+	});
 
-			if (e.isDoor) {
+	systemScheduler.addSystem({
+		.name = "ElevatorButtons",
+		.access = SystemAccess().read<ButtonComponent, ButterController, BreadController, ObjectInfoComponent>().write<ElevatorComponent>(),
+		.update = [this]()
+		{
+			auto& collisions = scene->getCollisionSystem().GetCollisions();
+
+			std::unordered_set<EntityID> pressedButtons;
+			auto isPlayer = [&](EntityID id) {
+				return scene->hasComponent<ButterController>(id) ||
+					scene->hasComponent<BreadController>(id);
+				};
+			auto isButton = [&](EntityID id) {
+				return scene->hasComponent<ButtonComponent>(id);
+				};
+			for (auto& col : collisions) {
+				if ((isPlayer(col.objectA) && isButton(col.objectB)) ||
+					(isPlayer(col.objectB) && isButton(col.objectA)))
+				{
+					bool isEntAButton = isButton(col.objectA);
+					EntityID btn = isEntAButton ? col.objectA : col.objectB;
+					EntityID playerId = !isEntAButton ? col.objectA : col.objectB;
 
-				float dir = (e.doorDir == ElevatorComponent::DoorDir::Left ? -1.0f : +1.0f);
-				float minX = e.closedPos.x;
-				float maxX = e.closedPos.x + e.openHeight * dir;
+					const auto& button = std::as_const(*scene).getComponent<ButtonComponent>(btn);
 
-				if (e.state == ElevatorState::Opening) {
-					tr.translation.x += delta * dir;
-					if ((dir > 0 && tr.translation.x >= maxX) ||
-						(dir < 0 && tr.translation.x <= maxX))
+					if (!button.playerTag.empty())
 					{
-						tr.translation.x = maxX;
-						e.state = ElevatorState::Open;
-						e.isMoving = false;
-						spdlog::info("Door opened!");
+						if (!scene->hasTag(playerId, button.playerTag)) {
+							continue;
+						}
 					}
-				}
-				else if (e.state == ElevatorState::Closing) {
-					tr.translation.x -= delta * dir;
-					if ((dir > 0 && tr.translation.x <= minX) ||
-						(dir < 0 && tr.translation.x >= minX))
+					if (abs(col.separationVector.x) < 0.001f && abs(col.separationVector.z) < 0.001f)
 					{
-						tr.translation.x = minX;
-						e.state = ElevatorState::Closed;
-						e.isMoving = false;
-						spdlog::info("Door closed!");
+						pressedButtons.insert(btn);
 					}
 				}
 			}
-			else {
-
-				float minY = e.closedPos.y;
-				float maxY = e.closedPos.y + e.openHeight;
-
-				if (e.state == ElevatorState::Opening) {
-					tr.translation.y += delta;
-					if (tr.translation.y >= maxY) {
-						tr.translation.y = maxY;
-						e.state = ElevatorState::Open;
-						e.isMoving = false;
-						spdlog::info("Elevator ruszyla");
+
+
+			{
+				auto elevators = scene->getStorage<ElevatorComponent>();
+				scene->view<ButtonComponent>().each([&](EntityID id, ButtonComponent& btn) {
+					if (!scene->isActive(id))
+						return;
+					if (!elevators || !elevators->has(btn.elevatorEntity)) return;
+					auto& e = elevators->get(btn.elevatorEntity);
+
+					bool nowPressed = pressedButtons.count(btn.id) > 0;
+
+					if (e.isDoor) {
+
+						if (e.locked) {
+
+							if (nowPressed && e.state == ElevatorState::Closed) {
+								e.state = ElevatorState::Opening;
+								e.isMoving = true;
+							}
+							else if (nowPressed && e.state == ElevatorState::Open) {
+								e.state = ElevatorState::Closing;
+								e.isMoving = true;
+							}
+						}
+						else {
+
+							if (nowPressed && e.state != ElevatorState::Opening && e.state != ElevatorState::Open) {
+								e.state = ElevatorState::Opening;
+								e.isMoving = true;
+							}
+							else if (!nowPressed && e.state != ElevatorState::Closing && e.state != ElevatorState::Closed) {
+								e.state = ElevatorState::Closing;
+								e.isMoving = true;
+							}
+						}
 					}
-				}
-				else if (e.state == ElevatorState::Closing) {
-					tr.translation.y -= delta;
-					if (tr.translation.y <= minY) {
-						tr.translation.y = minY;
-						e.state = ElevatorState::Closed;
-						e.isMoving = false;
-						spdlog::info("Elevator zastopowala");
+					else {
+
+						if (nowPressed && e.state != ElevatorState::Opening && e.state != ElevatorState::Open) {
+							e.state = ElevatorState::Opening;
+							e.isMoving = true;
+						}
+						else if (!nowPressed && e.state != ElevatorState::Closing && e.state != ElevatorState::Closed) {
+							e.state = ElevatorState::Closing;
+							e.isMoving = true;
+						}
 					}
-				}
+				});
 			}
+		},
+	});
 
-			scene->getTransformSystem().translateEntity(e.id, tr.translation);
-		}
-	}
-
-	{
-		auto& aiSystem = scene->getFlyAISystem();
-		aiSystem.deltaTime = deltaTime;
-		aiSystem.update();
-	}
-	ts.update();
-
-	if (auto bhs = scene->getStorage<ButterHealthComponent>()) {
-		if (auto bhs = scene->getStorage<ButterHealthComponent>()) {
-			auto transforms = scene->getStorage<Transform>();
-			for (int i = 0; i < bhs->getQuantity(); ++i) {
-				auto& bh = bhs->components[i];
-				auto& tr = transforms->get(bh.id);
-
-
-				if (bh.burning && bh.timeLeft > 0.0f)
-					bh.timeLeft -= deltaTime;
-
-				if (bh.healing && bh.timeLeft < bh.secondsToDie)
-					bh.timeLeft += deltaTime * (bh.secondsToDie / bh.secondsToHeal);
-
+	systemScheduler.addSystem({
+		.name = "ElevatorMovement",
+		.access = SystemAccess().read<Transform>().write<ElevatorComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
+		{
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			{
+				scene->view<ElevatorComponent, Transform>().each([&](EntityID id, ElevatorComponent& e, const Transform& tr) {
+					if (!e.isMoving || !tr.isActive) return;
 
-				bh.timeLeft = glm::clamp(bh.timeLeft, 0.0f, bh.secondsToDie);
+					glm::vec3 translation = tr.translation;
 
 
-				float lostRatio = 1.0f - (bh.timeLeft / bh.secondsToDie);
-				float scaleRatio = glm::mix(1.0f, bh.minScale, lostRatio);
-				tr.scale = bh.startScale * scaleRatio;
+					if (!e.hasInitClosedPos) {
+						e.closedPos = translation;
+						e.hasInitClosedPos = true;
+					}
 
+					float delta = e.speed * deltaTime;
+
+					if (e.isDoor) {
+
+						float dir = (e.doorDir == ElevatorComponent::DoorDir::Left ? -1.0f : +1.0f);
+						float minX = e.closedPos.x;
+						float maxX = e.closedPos.x + e.openHeight * dir;
+
+						if (e.state == ElevatorState::Opening) {
+							translation.x += delta * dir;
+							if ((dir > 0 && translation.x >= maxX) ||
+								(dir < 0 && translation.x <= maxX))
+							{
+								translation.x = maxX;
+								e.state = ElevatorState::Open;
+								e.isMoving = false;
+								spdlog::info("Door opened!");
+							}
+						}
+						else if (e.state == ElevatorState::Closing) {
+							translation.x -= delta * dir;
+							if ((dir > 0 && translation.x <= minX) ||
+								(dir < 0 && translation.x >= minX))
+							{
+								translation.x = minX;
+								e.state = ElevatorState::Closed;
+								e.isMoving = false;
+								spdlog::info("Door closed!");
+							}
+						}
+					}
+					else {
+
+						float minY = e.closedPos.y;
+						float maxY = e.closedPos.y + e.openHeight;
+
+						if (e.state == ElevatorState::Opening) {
+							translation.y += delta;
+							if (translation.y >= maxY) {
+								translation.y = maxY;
+								e.state = ElevatorState::Open;
+								e.isMoving = false;
+								spdlog::info("Elevator ruszyla");
+							}
+						}
+						else if (e.state == ElevatorState::Closing) {
+							translation.y -= delta;
+							if (translation.y <= minY) {
+								translation.y = minY;
+								e.state = ElevatorState::Closed;
+								e.isMoving = false;
+								spdlog::info("Elevator zastopowala");
+							}
+						}
+					}
 
-				bh.burning = bh.healing = false;
+					transformWrites.translate(id, translation);
+				});
 			}
+		},
+	});
 
-			scene->getTransformSystem().update();
-		}
-
-
-	}
-
-	if (auto cc = scene->getStorage<CameraController>())
-	{
-		for (int i = 0; i < cc->getQuantity(); ++i)
+	systemScheduler.addSystem({
+		.name = "FlyAI",
+		.access = SystemAccess().read<Transform>().write<FlyAIComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
 		{
-			auto& controller = cc->components[i];
-			controller.update(window, scene.get(), deltaTime);
-		}
-	}
-	if (auto ssc = scene->getStorage<SplitScreenController>())
-	{
-		for (int i = 0; i < ssc->getQuantity(); ++i)
-		{
-			auto& controller = ssc->components[i];
-			controller.update(window, scene.get(), deltaTime);
-		}
-	}
-
-	EventSystem& eventSystem = scene->getEventSystem();
-	eventSystem.processEvents();
-}
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			auto& aiSystem = scene->getFlyAISystem();
+			aiSystem.deltaTime = deltaTime;
+			aiSystem.update(transformWrites);
+		},
+	});
 
+	systemScheduler.addSystem({
+		.name = "ButterHealth",
+		.access = SystemAccess().read<Transform>().write<ButterHealthComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
+		{
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			{
+				auto bhView = scene->view<ButterHealthComponent, Transform>();
+				if (bhView.sizeHint() > 0) {
+					bhView.each([&](EntityID id, ButterHealthComponent& bh, const Transform& transform) {
+						// odłożone ślady z puli mają ButterHealthComponent z prefabu - bez skalowania i oznaczania
+						if (!transform.isActive)
+							return;
 
 
+						if (bh.burning && bh.timeLeft > 0.0f)
+							bh.timeLeft -= deltaTime;
 
+						if (bh.healing && bh.timeLeft < bh.secondsToDie)
+							bh.timeLeft += deltaTime * (bh.secondsToDie / bh.secondsToHeal);
 
 
+						bh.timeLeft = glm::clamp(bh.timeLeft, 0.0f, bh.secondsToDie);
 
-// temporary
-static void lightSystem(const Scene& scene, UniformBlockStorage& uniformBlockStorage)
-{
-	auto& lightBlock = uniformBlockStorage.lightBlock;
-	auto transforms = scene.getStorage<Transform>();
 
-	glm::vec4 ambientColor = glm::vec4(0.3f, 0.3f, 0.3f, 1.0f); // Temporary ambient color
-	lightBlock.setData("ambientColor", &ambientColor);
+						float lostRatio = 1.0f - (bh.timeLeft / bh.secondsToDie);
+						float scaleRatio = glm::mix(1.0f, bh.minScale, lostRatio);
+						transformWrites.scale(id, bh.startScale * scaleRatio);
 
 
-	// point lights
-	int pointLightCount = 0;
+						bh.burning = bh.healing = false;
+					});
+				}
 
-	auto pointLights = scene.getStorage<PointLightComponent>();
-	if (pointLights == nullptr)
-	{
-		lightBlock.setData("pointLightCount", &pointLightCount);
-	}
-	else
-	{
-		pointLightCount = pointLights->getQuantity();
-		lightBlock.setData("pointLightCount", &pointLightCount);
 
+			}
+		},
+	});
 
-		for (int i = 0; i < pointLightCount; i++)
+	systemScheduler.addSystem({
+		.name = "CameraController",
+		.access = SystemAccess().read<CameraController, Transform>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
 		{
-			auto& light = pointLights->components[i];
-			std::string prefix = "pointLights[" + std::to_string(i) + "].";
-			glm::vec3 position = transforms->get(light.id).globalMatrix[3];
-			lightBlock.setData(prefix + "position", &position);
-			lightBlock.setData(prefix + "color", &light.color);
-			lightBlock.setData(prefix + "intensity", &light.intensity);
-			lightBlock.setData(prefix + "constant", &light.constant);
-			lightBlock.setData(prefix + "linear", &light.linear);
-			lightBlock.setData(prefix + "quadratic", &light.quadratic);
-		}
-	}
-
-	// directional lights
-	int directionalLightCount = 0;
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			scene->view<CameraController>().each([&](EntityID id, CameraController& controller)
+				{
+					if (!scene->isActive(id))
+						return;
+					controller.update(window, scene.get(), deltaTime, transformWrites);
+				});
+		},
+	});
 
-	auto directionalLights = scene.getStorage<DirectionalLightComponent>();
-	if (directionalLights == nullptr)
-	{
-		lightBlock.setData("directionalLightCount", &directionalLightCount);
-	}
-	else
-	{
-		directionalLightCount = directionalLights->getQuantity();
-		lightBlock.setData("directionalLightCount", &directionalLightCount);
+	systemScheduler.addSystem({
+		.name = "SplitScreenController",
+		.access = SystemAccess().read<Transform>().write<SplitScreenController, CameraComponent>(),
+		.update = [this, writeQueue = nextWriteQueue++]()
+		{
+			auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+			scene->view<SplitScreenController>().each([&](EntityID id, SplitScreenController& controller)
+				{
+					if (!scene->isActive(id))
+						return;
+					controller.update(window, scene.get(), deltaTime, transformWrites);
+				});
+		},
+	});
 
-		for (int i = 0; i < directionalLightCount; i++)
+	systemScheduler.addSystem({
+		.name = "Events",
+		.update = [this]()
 		{
-			auto& light = directionalLights->components[i];
-			std::string prefix = "directionalLights[" + std::to_string(i) + "].";
-			glm::vec3 direction = -transforms->get(light.id).globalMatrix[2];
-			lightBlock.setData(prefix + "direction", &direction);
-			lightBlock.setData(prefix + "color", &light.color);
-			lightBlock.setData(prefix + "intensity", &light.intensity);
-		}
-	}
+			scene->getEventSystem().processEvents();
+			scene->getCommandBuffer().playback();
+		},
+		.exclusive = true,
+	});
 
+	assert(nextWriteQueue <= TransformSystem::MAX_WRITE_QUEUES && "Application: too many systems with transform write queues");
 }
 
 
@@ -652,45 +697,25 @@ void Application::render(const Framebuffer& framebuffer)
 
 	//scene->getRenderingSystem().buildTree();
 
-	lightSystem(*scene, uniformBlockStorage);
+	renderingSystem.uploadLights(uniformBlockStorage);
 
-	auto transforms = scene->getStorage<Transform>();
 	auto cameras = scene->getStorage<CameraComponent>();
 
 	auto [fboWidth, fboHeight] = framebuffer.GetSizePair();
 	float aspectRatio = static_cast<float>(fboWidth) / static_cast<float>(fboHeight);
 
-	for (int i = 0; i < cameras->getQuantity(); i++)
-	{
-		auto& cameraComponent = cameras->components[i];
-		auto& transform = transforms->get(cameraComponent.id);
-		if (cameraComponent.camera.getInvViewMatrix() != transform.globalMatrix)
-		{
-			cameraComponent.camera.setInvViewMatrix(transform.globalMatrix);
-		}
-		if (cameraComponent.aspectRatio != aspectRatio)
-		{
-			cameraComponent.aspectRatio = aspectRatio;
-			cameraComponent.dirty = true;
-		}
-
-		if (cameraComponent.dirty)
-		{
-			cameraComponent.updateProjectionMatrix();
-		}
-
+	renderingSystem.updateCameras(aspectRatio);
 
-	}
 	auto splitScreenControllers = scene->getStorage<SplitScreenController>();
 
 	if (cameras->getQuantity() > 1 && splitScreenControllers != nullptr && splitScreenControllers->getQuantity() >= 1)
 	{
 		auto& ssc = splitScreenControllers->components[0];
 		auto& cam1 = scene->getComponent<CameraComponent>(ssc.camera1);
-		glm::vec3& p1 = scene->getComponent<Transform>(ssc.target1).translation;
+		const glm::vec3& p1 = std::as_const(*scene).getComponent<Transform>(ssc.target1).translation;
 
 		auto& cam2 = scene->getComponent<CameraComponent>(ssc.camera2);
-		glm::vec3& p2 = scene->getComponent<Transform>(ssc.target2).translation;
+		const glm::vec3& p2 = std::as_const(*scene).getComponent<Transform>(ssc.target2).translation;
 
 
 
@@ -728,20 +753,20 @@ void Application::render(const Framebuffer& framebuffer)
 
 
 
-			renderingSystem.drawScene(framebuffer, cam1.camera, &cam2.camera, uniformBlockStorage, postShaders);
+			renderingSystem.drawScene(*renderer, framebuffer, cam1.camera, &cam2.camera, uniformBlockStorage, postShaders);
 		}
 		else
 		{
 			cam1.screenOffset = glm::vec2(0.0f, 0.0f);
 			cam1.updateProjectionMatrix();
-			renderingSystem.drawScene(framebuffer, cam1.camera, nullptr, uniformBlockStorage, postShaders);
+			renderingSystem.drawScene(*renderer, framebuffer, cam1.camera, nullptr, uniformBlockStorage, postShaders);
 		}
 	}
 	else
 	{
-		renderingSystem.drawScene(framebuffer, cameras->components[0].camera, nullptr, uniformBlockStorage, postShaders);
+		renderingSystem.drawScene(*renderer, framebuffer, cameras->components[0].camera, nullptr, uniformBlockStorage, postShaders);
 	}
-	renderingSystem.drawHud(framebuffer);
+	renderingSystem.drawHud(*renderer, framebuffer);
 }
 
 
@@ -755,10 +780,10 @@ void Application::render(Camera& camera, const Framebuffer& framebuffer)
 
 	//scene->getRenderingSystem().buildTree();
 
-	lightSystem(*scene, uniformBlockStorage);
+	scene->getRenderingSystem().uploadLights(uniformBlockStorage);
 
-	scene->getRenderingSystem().drawScene(framebuffer, camera, nullptr, uniformBlockStorage, postShaders);
-	scene->getRenderingSystem().drawHud(framebuffer);
+	scene->getRenderingSystem().drawScene(*renderer, framebuffer, camera, nullptr, uniformBlockStorage, postShaders);
+	scene->getRenderingSystem().drawHud(*renderer, framebuffer);
 }
 
 void Application::renderToWindow()
@@ -789,17 +814,31 @@ std::vector<EntityID> Application::instantiatePrefab(const std::string& prefabNa
 		parent = scene.getSceneRootEntity();
 	}
 
-	auto it = prefabs.find(prefabName);
-	if (it == prefabs.end())
+	auto it = prefabTemplates.find(prefabName);
+	if (it == prefabTemplates.end())
 	{
 		return {};
 	}
 
-	json prefabData = it->second;
-	std::vector<EntityID> instantiatedEntities = Serialization::deserializeObjects(
-		prefabData, scene, parent, { shaders, models, false });
+	return it->second.instantiate(scene, parent);
+}
 
-	return instantiatedEntities;
+const PrefabTemplate* Application::findPrefab(const std::string& prefabName) const
+{
+	auto it = prefabTemplates.find(prefabName);
+	return it != prefabTemplates.end() ? &it->second : nullptr;
+}
+
+void Application::compilePrefab(const std::string& prefabName)
+{
+	auto it = prefabs.find(prefabName);
+	if (it == prefabs.end())
+	{
+		prefabTemplates.erase(prefabName);
+		return;
+	}
+
+	prefabTemplates[prefabName] = PrefabTemplate::compile(it->second, { shaders, models, false });
 }
 
 
@@ -840,11 +879,11 @@ void Application::setupScene()
 
 
 	ent = scene->getSceneRootEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Root";
+	scene->setEntityName(ent, "Root");
 
 
 	ent = player = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Maslo";
+	scene->setEntityName(ent, "Maslo");
 	ts.scaleEntity(ent, glm::vec3(0.003f, 0.003f, 0.003f));
 	ts.translateEntity(ent, glm::vec3(0.0f, 1.0f, 0.0f));
 	scene->getComponent<Transform>(ent).isStatic = false;
@@ -859,14 +898,14 @@ void Application::setupScene()
 	scene->addComponent<ButterController>(ent, { 3.0f, 5.0f });
 	auto& bh = scene->addComponent<ButterHealthComponent>(ent, {});
 	bh.startScale = scene->getComponent<Transform>(ent).scale;
-	scene->getComponent<ObjectInfoComponent>(ent).tag = "maslo";
+	scene->setEntityTag(ent, "maslo");
 
 
 
 
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Camera";
+	scene->setEntityName(ent, "Camera");
 	auto& playerCam = scene->addComponent<CameraComponent>(ent, {});
 	playerCam.camera.getFrustum().setProjectionMatrix(
 		glm::perspective(glm::radians(45.0f), (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 0.1f, 100.0f));
@@ -875,7 +914,7 @@ void Application::setupScene()
 
 	//mucha
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Fly";
+	scene->setEntityName(ent, "Fly");
 
 	ts.scaleEntity(ent, glm::vec3(0.01f, 0.004f, 0.01f));
 	ts.translateEntity(ent, glm::vec3(2.5f, 3.0f, 0.0f));
@@ -906,7 +945,7 @@ void Application::setupScene()
 
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Chleb";
+	scene->setEntityName(ent, "Chleb");
 
 	ts.scaleEntity(ent, glm::vec3(0.005f, 0.005f, 0.005f));
 	ts.translateEntity(ent, glm::vec3(2.5f, 1.0f, 0.0f));
@@ -920,7 +959,7 @@ void Application::setupScene()
 	scene->addComponent<BreadController>(ent, { 3.0f, 5.0f });
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Floor";
+	scene->setEntityName(ent, "Floor");
 
 	ts.scaleEntity(ent, glm::vec3(5.0, 0.1f, 5.0f));
 
@@ -938,7 +977,7 @@ void Application::setupScene()
 
 	for (int i = 0; i < 3; ++i) {
 		ent = scene->createEntity();
-		scene->getComponent<ObjectInfoComponent>(ent).name = "Wall " + std::to_string(i + 1);
+		scene->setEntityName(ent, "Wall " + std::to_string(i + 1));
 
 		ts.scaleEntity(ent, wallScalesAndTranslations[i].first);
 		ts.translateEntity(ent, wallScalesAndTranslations[i].second);
@@ -949,7 +988,7 @@ void Application::setupScene()
 
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Wall 5";
+	scene->setEntityName(ent, "Wall 5");
 
 	ts.rotateEntity(ent, glm::vec3(0.0f, 30.0f, 180.0f));
 	ts.translateEntity(ent, glm::vec3(1.0f, 1.0f, 2.0f));
@@ -960,14 +999,14 @@ void Application::setupScene()
 
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Cloud";
+	scene->setEntityName(ent, "Cloud");
 
 	scene->addComponent(ent, ImageComponent{ shaders[3], "res/textures/cloud.png" });
 	ts.translateEntity(ent, glm::vec3(9 * WINDOW_WIDTH / 10, WINDOW_HEIGHT / 10, 0.0f));
 	ts.scaleEntity(ent, glm::vec3(250.0f));
 
 	ent = scene->createEntity();
-	scene->getComponent<ObjectInfoComponent>(ent).name = "Text";
+	scene->setEntityName(ent, "Text");
 
 	scene->addComponent(ent, TextComponent{ shaders[4], "foo", glm::vec4(1, 0, 0, 1), "text" });
 	ts.translateEntity(ent, glm::vec3(1 * WINDOW_WIDTH / 10, WINDOW_HEIGHT / 10, 0.0f));
@@ -976,7 +1015,7 @@ void Application::setupScene()
 	/*for (int x = 0; x < 100; ++x) {
 		for (int z = 0; z < 10; ++z) {
 			ent = scene->createEntity();
-			scene->getComponent<ObjectInfoComponent>(ent).name = "Nanosuit_" + std::to_string(x) + "_" + std::to_string(z);
+			scene->setEntityName(ent, "Nanosuit_" + std::to_string(x) + "_" + std::to_string(z));
 
 			ts.translateEntity(ent, glm::vec3(x * 2.0f, 0.0f, z * 2.0f));
 			ts.scaleEntity(ent, glm::vec3(0.1f, 0.1f, 0.1f));
@@ -993,34 +1032,28 @@ void Application::setupScene()
 
 void Application::setupEvents()
 {
-	EventSystem& eventSystem = scene->getEventSystem();
+	CollisionSystem& collisionSystem = scene->getCollisionSystem();
+
+	// zdarzenia kolizji przychodzą dla obu kolejności pary, więc filtr <A, B> wystarcza
+	// także tam, gdzie obiekty mogą zderzyć się w dowolnej kolejności
 
 	// reset stanu much po zaatakowaniu masła
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& event = static_cast<const CollisionEvent&>(e);
+	collisionSystem.onCollision<FlyAIComponent, ButterController>([&](const CollisionEvent& event) {
 		if (!event.isColliding) return;
 
-		if (scene->hasComponent<FlyAIComponent>(event.objectA) &&
-			scene->hasComponent<ButterController>(event.objectB))
-		{
-			spdlog::info("mucha uderzyla!({} vs {})", event.objectA, event.objectB);
-			FlyAIComponent& fly = scene->getComponent<FlyAIComponent>(event.objectA);
-			fly.diveCooldownTimer = fly.diveCooldownTime;
-			fly.state = fly.Returning;
-		}
+		spdlog::info("mucha uderzyla!({} vs {})", event.objectA, event.objectB);
+		FlyAIComponent& fly = scene->getComponent<FlyAIComponent>(event.objectA);
+		fly.diveCooldownTimer = fly.diveCooldownTime;
+		fly.state = fly.Returning;
 	});
 
 
 	// zerowanie pionowej prędkości po dotknięciu podłoża
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& event = static_cast<const CollisionEvent&>(e);
+	collisionSystem.onCollision<VelocityComponent>([&](const CollisionEvent& event) {
 		if (!event.isColliding) return;
 
-		if (!scene->hasComponent<VelocityComponent>(event.objectA))
-			return;
-
 		VelocityComponent* velocityComponent = &scene->getComponent<VelocityComponent>(event.objectA);
 
 		if (event.separationVector.y > 0.01f && velocityComponent->useGravity
@@ -1034,13 +1067,9 @@ void Application::setupEvents()
 	// ponowne umożliwienie skakania po dotknięciu podłoża
 	// chleb
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& event = static_cast<const CollisionEvent&>(e);
+	collisionSystem.onCollision<BreadController>([&](const CollisionEvent& event) {
 		if (!event.isColliding) return;
 
-		if (!scene->hasComponent<BreadController>(event.objectA))
-			return;
-
 		BreadController* breadController = &scene->getComponent<BreadController>(event.objectA);
 
 		if (event.separationVector.y > 0.01f)
@@ -1052,13 +1081,9 @@ void Application::setupEvents()
 
 	// masło
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& event = static_cast<const CollisionEvent&>(e);
+	collisionSystem.onCollision<ButterController>([&](const CollisionEvent& event) {
 		if (!event.isColliding) return;
 
-		if (!scene->hasComponent<ButterController>(event.objectA))
-			return;
-
 		ButterController* butterController = &scene->getComponent<ButterController>(event.objectA);
 
 		if (event.separationVector.y > 0.01f)
@@ -1071,15 +1096,9 @@ void Application::setupEvents()
 
 	// odbijanie się masła od chleba
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& event = static_cast<const CollisionEvent&>(e);
+	collisionSystem.onCollision<Components<ButterController, VelocityComponent>, BreadController>([&](const CollisionEvent& event) {
 		if (!event.isColliding) return;
 
-		if (!scene->hasComponent<ButterController>(event.objectA) ||
-			!scene->hasComponent<VelocityComponent>(event.objectA) ||
-			!scene->hasComponent<BreadController>(event.objectB))
-			return;
-
 		ButterController* butter = &scene->getComponent<ButterController>(event.objectA);
 		BreadController* bread = &scene->getComponent<BreadController>(event.objectB);
 
@@ -1094,54 +1113,28 @@ void Application::setupEvents()
 		}
 	});
 	//heat
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e)
+	collisionSystem.onCollision<Components<ButterController, ButterHealthComponent>, HeatComponent>([&](const CollisionEvent& ev)
 		{
-			const auto& ev = static_cast<const CollisionEvent&>(e);
-
-			auto isMaslo = [&](EntityID id)
-				{ return scene->hasComponent<ObjectInfoComponent>(id) &&
-				scene->getComponent<ObjectInfoComponent>(id).tag == "maslo"; };
-
-			auto isHeat = [&](EntityID id)
-				{ return scene->hasComponent<HeatComponent>(id); };
-
-			if (!((isMaslo(ev.objectA) && isHeat(ev.objectB)) ||
-				(isMaslo(ev.objectB) && isHeat(ev.objectA))))
+			if (!scene->hasTag(ev.objectA, "maslo"))
 				return;
 
-			EntityID masloID = isMaslo(ev.objectA) ? ev.objectA : ev.objectB;
-
 			spdlog::info("cieplo");
-			scene->getComponent<ButterHealthComponent>(masloID).burning = true;
+			scene->getComponent<ButterHealthComponent>(ev.objectA).burning = true;
 
 			
-			scene->getComponent<ButterController>(masloID).inHeat = true;
+			scene->getComponent<ButterController>(ev.objectA).inHeat = true;
 		});
 
 
 	//freeze
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e)
+	collisionSystem.onCollision<BreadController, FreezeComponent>([&](const CollisionEvent& ev)
 		{
-			const auto& ev = static_cast<const CollisionEvent&>(e);
 			if (!ev.isColliding) return;
 
-			auto isFreeze = [&](EntityID id)
-				{ return scene->hasComponent<FreezeComponent>(id); };
-
-			auto isChleb = [&](EntityID id)
-				{ return scene->hasComponent<ObjectInfoComponent>(id) &&
-				scene->getComponent<ObjectInfoComponent>(id).tag == "chleb"; };
-
-			bool aFreeze = isFreeze(ev.objectA);
-			bool bFreeze = isFreeze(ev.objectB);
-			bool aChleb = isChleb(ev.objectA);
-			bool bChleb = isChleb(ev.objectB);
-
-			if ((aFreeze && bChleb) || (bFreeze && aChleb))
+			if (scene->hasTag(ev.objectA, "chleb"))
 			{
 				spdlog::info("zimno");
-				EntityID breadID = aChleb ? ev.objectA : ev.objectB;
-				scene->getComponent<BreadController>(breadID).freezing = true;
+				scene->getComponent<BreadController>(ev.objectA).freezing = true;
 			}
 
 		});
@@ -1149,42 +1142,26 @@ void Application::setupEvents()
 
 
 	//regen
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e)
+	collisionSystem.onCollision<ButterHealthComponent, RegenComponent>([&](const CollisionEvent& ev)
 		{
-			const auto& ev = static_cast<const CollisionEvent&>(e);
 			if (!ev.isColliding) return;
 
-			auto isMaslo = [&](EntityID id) { return scene->hasComponent<ObjectInfoComponent>(id)
-				&& scene->getComponent<ObjectInfoComponent>(id).tag == "maslo"; };
-			auto isRegen = [&](EntityID id) { return scene->hasComponent<RegenComponent>(id); };
-
-			bool condition = (isMaslo(ev.objectA) && isRegen(ev.objectB)) ||
-				(isMaslo(ev.objectB) && isRegen(ev.objectA));
-			if (!condition) return;
+			if (!scene->hasTag(ev.objectA, "maslo")) return;
 
 
-			auto& regen = scene->getComponent<RegenComponent>(
-				isRegen(ev.objectA) ? ev.objectA : ev.objectB);
+			auto& regen = scene->getComponent<RegenComponent>(ev.objectB);
 			spdlog::info("{}", regen.OnEnterMessage);
 
 
-			auto& bh = scene->getComponent<ButterHealthComponent>(
-				isMaslo(ev.objectA) ? ev.objectA : ev.objectB);
+			auto& bh = scene->getComponent<ButterHealthComponent>(ev.objectA);
 			bh.healing = true;
 		});
 
 
-	eventSystem.registerListener<CollisionEvent>([&](const Event& e) {
-		const auto& ev = static_cast<const CollisionEvent&>(e);
+	// przycisk windy - naciska go masło albo chleb
+	auto onButtonCollision = [&](const CollisionEvent& ev) {
 		if (!ev.isColliding) return;
 
-		if (!(scene->hasComponent<ButterController>(ev.objectA)
-			|| scene->hasComponent<BreadController>(ev.objectA))
-			|| !scene->hasComponent<ButtonComponent>(ev.objectB))
-		{
-			return;
-		}
-
 		if (ev.separationVector.y < 0.01f) return;
 
 		auto& button = scene->getComponent<ButtonComponent>(ev.objectB);
@@ -1192,8 +1169,7 @@ void Application::setupEvents()
 
 		if (!button.playerTag.empty())
 		{
-			auto& playerInfo = scene->getComponent<ObjectInfoComponent>(ev.objectA);
-			if (playerInfo.tag != button.playerTag) {
+			if (!scene->hasTag(ev.objectA, button.playerTag)) {
 				return;
 			}
 		}
@@ -1206,7 +1182,9 @@ void Application::setupEvents()
 			elevator.isMoving = true;
 			spdlog::info("Elevator start moving!");
 		}
-	});
+	};
+	collisionSystem.onCollision<ButterController, ButtonComponent>(onButtonCollision);
+	collisionSystem.onCollision<BreadController, ButtonComponent>(onButtonCollision);
 
 }
 
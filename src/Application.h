@@ -12,10 +12,13 @@
 #include "Shader.h"
 #include "Model.h"
 #include "Scene.h"
+#include "Renderer.h"
+#include "PrefabTemplate.h"
 
 #include "UniformBuffer.h"
 
 #include "ECS/TransformSystem.h"
+#include "ECS/SystemScheduler.h"
 
 #include "nlohmann/json.hpp"
 
@@ -44,6 +47,7 @@ public:
 	}
 
 	std::vector<EntityID> instantiatePrefab(const std::string& prefabName, Scene& scene, EntityID parent = (EntityID)-1);
+	const PrefabTemplate* findPrefab(const std::string& prefabName) const;
 
 protected:
 	bool init();
@@ -82,13 +86,23 @@ protected:
 	std::vector<Model*> models;
 
 	std::unordered_map<std::string, json> prefabs;
+	// prefabs skompilowane do postaci gotowej do instancjonowania, odświeżane przez compilePrefab()
+	std::unordered_map<std::string, PrefabTemplate> prefabTemplates;
+
+	// zasoby GPU wspólne dla wszystkich scen (również kopii w edytorze)
+	std::unique_ptr<Renderer> renderer;
 
 	std::shared_ptr<Scene> scene;
 
+	// systemy wykonywane w update(), równolegle tam, gdzie pozwalają na to zadeklarowane komponenty
+	SystemScheduler systemScheduler;
+
 	// TODO: player component
 	EntityID player = (EntityID)-1;
 
 	void setupEvents();
+	void setupSystems();
+	void compilePrefab(const std::string& prefabName);
 	void setStartValues();
 
 private:
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+template<typename Signature, size_t Capacity = 32>
+class Delegate;
+
+// Odpowiednik std::function z obiektem funkcyjnym zawsze w buforze wewnętrznym - bez alokacji.
+// Za duży obiekt (np. lambda przechwytująca kontener przez wartość) to błąd kompilacji,
+// wtedy trzeba przechwycić wskaźnik albo zwiększyć Capacity.
+template<typename R, typename... Args, size_t Capacity>
+class Delegate<R(Args...), Capacity>
+{
+public:
+	Delegate() = default;
+	Delegate(std::nullptr_t) {}
+
+	template<typename F, typename Fn = std::decay_t<F>>
+		requires (!std::is_same_v<Fn, Delegate> && std::is_invocable_r_v<R, Fn&, Args...>)
+	Delegate(F&& function)
+	{
+		static_assert(sizeof(Fn) <= Capacity, "Delegate: callable does not fit the inline buffer");
+		static_assert(alignof(Fn) <= alignof(std::max_align_t), "Delegate: unsupported alignment");
+		static_assert(std::is_nothrow_move_constructible_v<Fn>, "Delegate: callable must be nothrow movable");
+		static_assert(std::is_copy_constructible_v<Fn>, "Delegate: callable must be copyable");
+
+		new (storage) Fn(std::forward<F>(function));
+		invoker = [](void* object, Args... args) -> R {
+			return std::invoke(*static_cast<Fn*>(object), std::forward<Args>(args)...);
+		};
+		manager = [](Operation operation, void* target, void* source) {
+			switch (operation)
+			{
+			case Operation::COPY:
+				new (target) Fn(*static_cast<const Fn*>(source));
+				break;
+			case Operation::MOVE:
+				new (target) Fn(std::move(*static_cast<Fn*>(source)));
+				static_cast<Fn*>(source)->~Fn();
+				break;
+			case Operation::DESTROY:
+				static_cast<Fn*>(target)->~Fn();
+				break;
+			}
+		};
+	}
+
+	Delegate(const Delegate& other)
+	{
+		copyFrom(other);
+	}
+
+	Delegate(Delegate&& other) noexcept
+	{
+		moveFrom(other);
+	}
+
+	Delegate& operator=(const Delegate& other)
+	{
+		if (this != &other)
+		{
+			reset();
+			copyFrom(other);
+		}
+		return *this;
+	}
+
+	Delegate& operator=(Delegate&& other) noexcept
+	{
+		if (this != &other)
+		{
+			reset();
+			moveFrom(other);
+		}
+		return *this;
+	}
+
+	Delegate& operator=(std::nullptr_t)
+	{
+		reset();
+		return *this;
+	}
+
+	~Delegate()
+	{
+		reset();
+	}
+
+	explicit operator bool() const { return invoker != nullptr; }
+
+	R operator()(Args... args) const
+	{
+		return invoker(storage, std::forward<Args>(args)...);
+	}
+
+private:
+	enum class Operation { COPY, MOVE, DESTROY };
+
+	alignas(std::max_align_t) mutable std::byte storage[Capacity];
+	R (*invoker)(void*, Args...) = nullptr;
+	void (*manager)(Operation, void*, void*) = nullptr;
+
+	void reset()
+	{
+		if (manager)
+			manager(Operation::DESTROY, storage, nullptr);
+		invoker = nullptr;
+		manager = nullptr;
+	}
+
+	void copyFrom(const Delegate& other)
+	{
+		if (!other.manager)
+			return;
+		other.manager(Operation::COPY, storage, other.storage);
+		invoker = other.invoker;
+		manager = other.manager;
+	}
+
+	void moveFrom(Delegate& other)
+	{
+		if (!other.manager)
+			return;
+		other.manager(Operation::MOVE, storage, other.storage);
+		invoker = other.invoker;
+		manager = other.manager;
+		other.invoker = nullptr;
+		other.manager = nullptr;
+	}
+};
@@ -2,14 +2,21 @@
 
 #include "Scene.h"
 #include "Components.h"
+#include "JobSystem.h"
 
+#include <algorithm>
+#include <bit>
+#include <cassert>
 #include <functional>
 
+#include <spdlog/spdlog.h>
+
 struct ColliderObjectInfo
 {
 	Transform* transform;
 	ColliderComponent* collider;
 	ColliderShape* shape;
+	uint64_t componentMask;
 };
 
 
@@ -62,14 +69,26 @@ void CollisionSystem::CheckCollisions()
 	for (int i = 0; i < colliderStorage->getQuantity(); i++)
 	{
 		auto& colliderComponent = colliderStorage->components[i];
+		auto& transform = transformStorage->get(colliderComponent.id);
+		if (!transform.isActive)
+			continue;
 		colliderObjects.push_back({
-				.transform = &transformStorage->get(colliderComponent.id),
+				.transform = &transform,
 				.collider = &colliderComponent,
-				.shape = colliderComponent.GetColliderShape()
+				.shape = colliderComponent.GetColliderShape(),
+				.componentMask = componentMask(colliderComponent.id)
 			});
 	}
 
-	for (size_t i = 0; i < colliderObjects.size(); ++i)
+	// pary (i, j) liczone równolegle, wyniki zbierane osobno dla każdego i,
+	// żeby kolejność kolizji nie zależała od liczby wątków
+	std::vector<std::vector<CollisionEvent>> collisionsPerObject(colliderObjects.size());
+
+	// zdarzenia wysyłane prosto z zadań; klucz (i, j) daje po scaleniu kolejność pętli sekwencyjnej
+	EventSystem& events = scene->getEventSystem();
+	events.prepareChannel<CollisionEvent>();
+
+	auto testRow = [&](size_t i)
 	{
 		for (size_t j = i + 1; j < colliderObjects.size(); ++j)
 		{
@@ -92,7 +111,7 @@ void CollisionSystem::CheckCollisions()
 			auto it = collisionFunctions.find(shapeTypePair);
 			if (it != collisionFunctions.end())
 			{
-				CollisionFunction collisionFunction = it->second;
+				const CollisionFunction& collisionFunction = it->second;
 				collisionInfo = collisionFunction(objectFirst, objectSecond);
 			}
 
@@ -100,19 +119,211 @@ void CollisionSystem::CheckCollisions()
 			{
 				collisionInfo.objectA = objectFirst.collider->id;
 				collisionInfo.objectB = objectSecond.collider->id;
+				collisionInfo.componentMaskA = objectFirst.componentMask;
+				collisionInfo.componentMaskB = objectSecond.componentMask;
 
-				collisions.push_back(collisionInfo);
-				scene->getEventSystem().queueEvent(collisionInfo);
+				collisionsPerObject[i].push_back(collisionInfo);
+
+				uint64_t orderKey = (uint64_t(i) << 32) | uint64_t(j);
+				events.queueEventConcurrent(orderKey, collisionInfo);
 
 				CollisionEvent swappedCollisionInfo = collisionInfo;
-				swappedCollisionInfo.objectA = objectSecond.collider->id;
-				swappedCollisionInfo.objectB = objectFirst.collider->id;
+				swappedCollisionInfo.objectA = collisionInfo.objectB;
+				swappedCollisionInfo.objectB = collisionInfo.objectA;
 				swappedCollisionInfo.separationVector = -swappedCollisionInfo.separationVector;
+				swappedCollisionInfo.componentMaskA = collisionInfo.componentMaskB;
+				swappedCollisionInfo.componentMaskB = collisionInfo.componentMaskA;
 
-				scene->getEventSystem().queueEvent(swappedCollisionInfo);
+				// ten sam klucz i ten sam wątek - zostaje tuż po zdarzeniu (A, B)
+				events.queueEventConcurrent(orderKey, swappedCollisionInfo);
 			}
+		}
+	};
+
+	// wiersz i ma n-1-i par, więc zadanie dostaje wiersze k i n-1-k - razem zawsze n-1 par;
+	// przy podziale po samym i pierwsze partie miałyby większość testów
+	size_t count = colliderObjects.size();
+	JobSystem::GetInstance().parallelFor(static_cast<uint32_t>((count + 1) / 2), 8,
+		[&](uint32_t begin, uint32_t end)
+	{
+		for (size_t k = begin; k < end; ++k)
+		{
+			testRow(k);
+			if (count - 1 - k != k)
+				testRow(count - 1 - k);
+		}
+	});
+
+	for (auto& objectCollisions : collisionsPerObject)
+	{
+		collisions.insert(collisions.end(), objectCollisions.begin(), objectCollisions.end());
+	}
+}
+
+ListenerHandle CollisionSystem::onCollision(EntityID entity, CollisionListener listener)
+{
+	return addListener(0, 0, entity, std::move(listener));
+}
 
+uint64_t CollisionSystem::filterBit(ComponentTypeID type)
+{
+	auto it = std::find(filterTypes.begin(), filterTypes.end(), type);
+	if (it == filterTypes.end())
+	{
+		// również w wydaniu - przesunięcie o 64 i więcej bitów dałoby maski innych typów
+		if (filterTypes.size() >= MAX_FILTER_TYPES)
+		{
+			spdlog::critical("CollisionSystem: more than {} component types in collision filters", MAX_FILTER_TYPES);
+			std::abort();
 		}
+		filterTypes.push_back(type);
+		listenersByComponent.emplace_back();
+		it = filterTypes.end() - 1;
+	}
+	return uint64_t(1) << (it - filterTypes.begin());
+}
+
+uint64_t CollisionSystem::componentMask(EntityID id) const
+{
+	const Scene& constScene = *scene;
+	uint64_t mask = 0;
+	for (size_t bit = 0; bit < filterTypes.size(); bit++)
+	{
+		if (constScene.hasComponent(filterTypes[bit], id))
+			mask |= uint64_t(1) << bit;
+	}
+	return mask;
+}
+
+ListenerHandle CollisionSystem::addListener(uint64_t maskA, uint64_t maskB, EntityID entity, CollisionListener listener)
+{
+	if (!subscription.isValid())
+	{
+		// całe zdarzenia z klatki naraz - bez wywołania przez std::function na każde zdarzenie
+		subscription = scene->getEventSystem().registerBatchListener<CollisionEvent>([this](std::span<const CollisionEvent> events) {
+			dispatching++;
+			for (const CollisionEvent& event : events)
+			{
+				dispatch(event);
+			}
+			dispatching--;
+
+			if (dispatching == 0 && !pendingListeners.empty())
+			{
+				for (FilteredListener& pending : pendingListeners)
+				{
+					listeners.push_back(std::move(pending));
+					if (!listeners.back().removed)
+						indexListener(static_cast<uint32_t>(listeners.size() - 1));
+				}
+				pendingListeners.clear();
+			}
+		});
+	}
+
+	FilteredListener filtered{ maskA, maskB, entity, nextOrder++, 0, false, std::move(listener) };
+	uint32_t slot;
+	if (dispatching > 0)
+	{
+		// dołączany do listeners i indeksowany po zakończeniu dispatch
+		slot = static_cast<uint32_t>(listeners.size() + pendingListeners.size());
+		pendingListeners.push_back(std::move(filtered));
+		return { eventTypeId<ListenerOwner>(), slot, 0, false };
+	}
+
+	if (!freeSlots.empty())
+	{
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+		filtered.generation = listeners[slot].generation;
+		listeners[slot] = std::move(filtered);
+	}
+	else
+	{
+		slot = static_cast<uint32_t>(listeners.size());
+		listeners.push_back(std::move(filtered));
+	}
+	indexListener(slot);
+	return { eventTypeId<ListenerOwner>(), slot, listeners[slot].generation, false };
+}
+
+void CollisionSystem::indexListener(uint32_t slot)
+{
+	const FilteredListener& filtered = listeners[slot];
+	if (filtered.entity != (EntityID)-1)
+		listenersByEntity[filtered.entity].push_back(slot);
+	else if (filtered.maskA != 0)
+		listenersByComponent[std::countr_zero(filtered.maskA)].push_back(slot);
+	else
+		unfilteredListeners.push_back(slot);
+}
+
+bool CollisionSystem::unregisterListener(ListenerHandle& handle)
+{
+	uint32_t slot = handle.slot;
+	uint32_t generation = handle.generation;
+	bool owned = handle.type == eventTypeId<ListenerOwner>();
+	handle = {};
+	if (!owned || slot >= listeners.size() + pendingListeners.size())
+		return false;
+
+	FilteredListener& filtered = slot < listeners.size() ? listeners[slot] : pendingListeners[slot - listeners.size()];
+	if (filtered.removed || filtered.generation != generation)
+		return false;
+
+	// delegat nie jest niszczony - listener może być właśnie wykonywany; slot wraca do puli
+	filtered.removed = true;
+	filtered.generation++;
+	freeSlots.push_back(slot);
+
+	if (slot < listeners.size())
+	{
+		if (filtered.entity != (EntityID)-1)
+		{
+			auto it = listenersByEntity.find(filtered.entity);
+			std::erase(it->second, slot);
+			if (it->second.empty())
+				listenersByEntity.erase(it);
+		}
+		else if (filtered.maskA != 0)
+			std::erase(listenersByComponent[std::countr_zero(filtered.maskA)], slot);
+		else
+			std::erase(unfilteredListeners, slot);
+	}
+	return true;
+}
+
+void CollisionSystem::dispatch(const CollisionEvent& event)
+{
+	// kandydaci tylko z typów, które ma objectA - listenery innych par nie są nawet sprawdzane
+	candidates.clear();
+	for (uint64_t mask = event.componentMaskA; mask != 0; mask &= mask - 1)
+	{
+		const auto& bucket = listenersByComponent[std::countr_zero(mask)];
+		candidates.insert(candidates.end(), bucket.begin(), bucket.end());
+	}
+	candidates.insert(candidates.end(), unfilteredListeners.begin(), unfilteredListeners.end());
+	if (!listenersByEntity.empty())
+	{
+		auto it = listenersByEntity.find(event.objectA);
+		if (it != listenersByEntity.end())
+			candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+	}
+
+	// kolejność rejestracji, jak w EventSystem
+	std::sort(candidates.begin(), candidates.end(), [&](uint32_t a, uint32_t b) { return listeners[a].order < listeners[b].order; });
+
+	for (uint32_t index : candidates)
+	{
+		const auto& filtered = listeners[index];
+		// usunięty przez wcześniejszy listener tego samego zdarzenia
+		if (filtered.removed)
+			continue;
+		if ((event.componentMaskA & filtered.maskA) != filtered.maskA ||
+			(event.componentMaskB & filtered.maskB) != filtered.maskB)
+			continue;
+
+		filtered.listener(event);
 	}
 }
 
@@ -1,7 +1,9 @@
 #pragma once
 
 #include <glm/vec3.hpp>
+#include <unordered_map>
 #include <vector>
+#include "ComponentStorage.h"
 #include "EntityManager.h"
 #include "EventSystem.h"
 
@@ -14,8 +16,18 @@ struct CollisionEvent final : public Event
 	EntityID objectA = -1;
 	EntityID objectB = -1;
 	glm::vec3 separationVector;
+
+	// bity typów z filtrów onCollision, które mają objectA/objectB - liczone raz na collider w CheckCollisions
+	uint64_t componentMaskA = 0;
+	uint64_t componentMaskB = 0;
 };
 
+using CollisionListener = Delegate<void(const CollisionEvent&)>;
+
+// Zestaw wymaganych komponentów dla jednej strony kolizji, np. onCollision<Components<ButterController, VelocityComponent>>
+template<typename... Ts>
+struct Components {};
+
 class CollisionSystem
 {
 private:
@@ -31,4 +43,78 @@ public:
 	{
 		return collisions;
 	}
+	// np. po przywróceniu sceny - wyniki ostatniego CheckCollisions dotyczą encji sprzed przywrócenia
+	void ClearCollisions()
+	{
+		collisions.clear();
+	}
+
+	// Listener dostaje tylko zdarzenia, w których objectA ma komponenty A, a objectB komponenty B
+	// (pojedynczy typ albo Components<...>, void - bez wymagań). Zdarzenia przychodzą w obu kolejnościach,
+	// więc para pasuje niezależnie od tego, który obiekt jest A.
+	// Różnych typów komponentów we wszystkich filtrach może być najwyżej MAX_FILTER_TYPES.
+	template<typename A, typename B = void>
+	ListenerHandle onCollision(CollisionListener listener)
+	{
+		uint64_t maskA = filterMask(static_cast<A*>(nullptr));
+		uint64_t maskB = filterMask(static_cast<B*>(nullptr));
+		return addListener(maskA, maskB, (EntityID)-1, std::move(listener));
+	}
+
+	// tylko zdarzenia z objectA == entity
+	ListenerHandle onCollision(EntityID entity, CollisionListener listener);
+
+	// false, jeśli listener był już usunięty albo uchwyt nie pochodzi z onCollision
+	bool unregisterListener(ListenerHandle& handle);
+
+	// bit maski komponentów na typ - liczba typów w filtrach
+	static constexpr uint32_t MAX_FILTER_TYPES = 64;
+
+private:
+	struct FilteredListener
+	{
+		uint64_t maskA;
+		uint64_t maskB;
+		EntityID entity;
+		// kolejność rejestracji - slot może być użyty ponownie
+		uint32_t order;
+		uint32_t generation;
+		bool removed;
+		CollisionListener listener;
+	};
+
+	// typ uchwytów z onCollision - bez kanału w EventSystem, więc EventSystem::unregisterListener ich nie usunie
+	struct ListenerOwner {};
+
+	// typy komponentów używane w filtrach, indeks = bit maski
+	std::vector<ComponentTypeID> filterTypes;
+	// indeks = slot uchwytu; usunięte wpisy czekają w freeSlots na ponowne użycie
+	std::vector<FilteredListener> listeners;
+	// dodane w trakcie dispatch - listeners nie może się wtedy realokować (wykonywany delegat leży w tablicy)
+	std::vector<FilteredListener> pendingListeners;
+	std::vector<uint32_t> freeSlots;
+	uint32_t nextOrder = 0;
+	uint32_t dispatching = 0;
+	// listenery według najniższego bitu maskA - sprawdzane tylko te, których typ ma objectA
+	std::vector<std::vector<uint32_t>> listenersByComponent;
+	std::vector<uint32_t> unfilteredListeners;
+	std::unordered_map<EntityID, std::vector<uint32_t>> listenersByEntity;
+	// bufor kandydatów w dispatch, używany ponownie
+	std::vector<uint32_t> candidates;
+	ListenerHandle subscription;
+
+	uint64_t filterBit(ComponentTypeID type);
+
+	static uint64_t filterMask(void*) { return 0; }
+
+	template<typename T>
+	uint64_t filterMask(T*) { return filterBit(componentTypeId<T>()); }
+
+	template<typename... Ts>
+	uint64_t filterMask(Components<Ts...>*) { return (filterBit(componentTypeId<Ts>()) | ... | 0); }
+
+	ListenerHandle addListener(uint64_t maskA, uint64_t maskB, EntityID entity, CollisionListener listener);
+	void indexListener(uint32_t slot);
+	void dispatch(const CollisionEvent& event);
+	uint64_t componentMask(EntityID id) const;
 };
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "CommandBuffer.h"
+
+#include "Scene.h"
+
+
+CommandBuffer::CommandBuffer(Scene* scene) : scene(scene)
+{
+}
+
+EntityID CommandBuffer::createEntity(EntityID parent) {
+    EntityID id = scene->entityManager.createEntity();
+    creates.push_back({ id, parent });
+    return id;
+}
+
+void CommandBuffer::destroyEntity(EntityID id) {
+    destroys.push_back(id);
+}
+
+void CommandBuffer::instantiatePrefab(const std::string& prefabName, EntityID parent, SpawnCallback onSpawned) {
+    prefabs.push_back({ prefabName, nullptr, parent, std::move(onSpawned) });
+}
+
+void CommandBuffer::acquirePooled(const PrefabTemplate* prefab, EntityID parent, SpawnCallback onSpawned) {
+    if (!prefab)
+        return;
+    prefabs.push_back({ {}, prefab, parent, std::move(onSpawned) });
+}
+
+bool CommandBuffer::empty() const {
+    if (!creates.empty() || !prefabs.empty() || !destroys.empty())
+        return false;
+    for (const auto& queue : componentQueues) {
+        if (queue && (queue->hasAdds() || queue->hasRemoves()))
+            return false;
+    }
+    return true;
+}
+
+void CommandBuffer::playback() {
+    while (!empty()) {
+        playbackOnce();
+    }
+}
+
+void CommandBuffer::playbackOnce() {
+    // SpawnCallback może dopisywać kolejne komendy - trafiają do pustych już creates/prefabs/destroys
+    std::vector<PendingEntity>& pendingCreates = playbackCreates;
+    std::vector<PendingPrefab>& pendingPrefabs = playbackPrefabs;
+    std::vector<EntityID>& pendingDestroys = playbackDestroys;
+    pendingCreates.swap(creates);
+    pendingPrefabs.swap(prefabs);
+    pendingDestroys.swap(destroys);
+
+    EntityManager& entityManager = scene->entityManager;
+
+    if (!pendingCreates.empty()) {
+        auto transforms = scene->getOrCreateStorage<Transform>();
+        auto transformInfos = scene->getOrCreateStorage<TransformInfoComponent>();
+        auto infos = scene->getOrCreateStorage<ObjectInfoComponent>();
+        uint32_t tick = scene->changeTick;
+
+        for (const auto& pending : pendingCreates) {
+            if (!entityManager.isAlive(pending.id))
+                continue;
+
+            EntityID parent = pending.parent;
+            if (!entityManager.isAlive(parent) || !transforms->has(parent)) parent = scene->sceneGraphRoot;
+
+            Transform transform;
+            transform.parent = parent;
+            transforms->add(pending.id, transform, tick);
+            transformInfos->add(pending.id, TransformInfoComponent{}, tick);
+            transformInfos->getForWrite(parent, tick).children.push_back(pending.id);
+            scene->transformSystem.onEntityCreated(pending.id);
+
+            ObjectInfoComponent info;
+            info.uuid = uuid::generate();
+            infos->add(pending.id, info, tick);
+            scene->indexObjectInfo(infos->get(pending.id));
+        }
+    }
+
+    for (auto& prefab : pendingPrefabs) {
+        if (prefab.pooledPrefab) {
+            const std::vector<EntityID>& spawned = scene->entityPool.acquire(prefab.pooledPrefab, prefab.parent);
+            if (prefab.onSpawned) {
+                prefab.onSpawned(*scene, spawned);
+            }
+            continue;
+        }
+
+        std::vector<EntityID> spawned = scene->instantiatePrefab(prefab.name, prefab.parent);
+        if (prefab.onSpawned) {
+            prefab.onSpawned(*scene, spawned);
+        }
+    }
+
+    // ObjectInfoComponent przez Scene - aktualizacja indeksów uuid/tag/nazwa
+    const ComponentTypeID objectInfoType = componentTypeId<ObjectInfoComponent>();
+    if (objectInfoType < componentQueues.size() && componentQueues[objectInfoType]) {
+        auto& infoQueue = static_cast<ComponentQueue<ObjectInfoComponent>&>(*componentQueues[objectInfoType]);
+        for (auto& [id, info] : infoQueue.adds) {
+            if (entityManager.isAlive(id) && !scene->hasComponent<ObjectInfoComponent>(id))
+                scene->addComponent<ObjectInfoComponent>(id, info);
+        }
+        infoQueue.adds.clear();
+        for (EntityID id : infoQueue.removes) {
+            if (scene->hasComponent<ObjectInfoComponent>(id))
+                scene->removeComponent<ObjectInfoComponent>(id);
+        }
+        infoQueue.removes.clear();
+    }
+
+    auto& storages = scene->storages;
+    for (ComponentTypeID type = 0; type < componentQueues.size(); type++) {
+        auto& queue = componentQueues[type];
+        if (!queue || !queue->hasAdds())
+            continue;
+
+        if (type >= storages.size()) {
+            storages.resize(type + 1);
+        }
+        if (!storages[type]) {
+            storages[type] = std::shared_ptr<IComponentStorage>(queue->createStorage());
+        } else {
+            Scene::detachStorage(storages[type]);
+        }
+        queue->applyAdds(*storages[type], entityManager, scene->changeTick);
+    }
+
+    for (ComponentTypeID type = 0; type < componentQueues.size(); type++) {
+        auto& queue = componentQueues[type];
+        if (!queue || !queue->hasRemoves())
+            continue;
+
+        IComponentStorage* storage = nullptr;
+        if (type < storages.size() && storages[type]) {
+            Scene::detachStorage(storages[type]);
+            storage = storages[type].get();
+        }
+        queue->applyRemoves(storage);
+    }
+
+    // nieaktualne ID (np. dzieci zniszczone już z rodzicem) są pomijane
+    scene->destroyEntities(pendingDestroys);
+
+    pendingCreates.clear();
+    pendingPrefabs.clear();
+    pendingDestroys.clear();
+}
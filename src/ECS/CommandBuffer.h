@@ -0,0 +1,140 @@
+#ifndef PBL_COMMANDBUFFER_H
+#define PBL_COMMANDBUFFER_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ComponentStorage.h"
+#include "EntityManager.h"
+#include "Delegate.h"
+
+class Scene;
+class PrefabTemplate;
+
+// Zmiany struktury sceny (tworzenie/niszczenie encji, dodawanie/usuwanie komponentów) zapisane w trakcie
+// iteracji systemów i wykonane hurtem w punkcie synchronizacji (playback).
+// Kolejność wykonania: nowe encje -> prefaby (także z EntityPool) -> dodane komponenty -> usunięte komponenty -> zniszczone encje.
+// Komponenty jednego typu trafiają do storage jednym przebiegiem, storage jest wyszukiwany raz na typ.
+class CommandBuffer {
+public:
+    // wywoływane po instancjonowaniu prefabu z ID utworzonych encji (pierwsza to korzeń prefabu);
+    // obiekt funkcyjny zawsze w buforze wewnętrznym - kolejkowanie spawnu nie alokuje
+    using SpawnCallback = Delegate<void(Scene&, const std::vector<EntityID>&)>;
+
+    explicit CommandBuffer(Scene* scene);
+
+    CommandBuffer(const CommandBuffer&) = delete;
+    CommandBuffer& operator=(const CommandBuffer&) = delete;
+    CommandBuffer(CommandBuffer&&) = default;
+    CommandBuffer& operator=(CommandBuffer&&) = default;
+
+    // ID jest rezerwowane od razu (można do niego dopisać komponenty), Transform i rodzic dochodzą przy playback
+    EntityID createEntity(EntityID parent = (EntityID)-1);
+    void destroyEntity(EntityID id);
+    void instantiatePrefab(const std::string& prefabName, EntityID parent = (EntityID)-1, SpawnCallback onSpawned = nullptr);
+    // jak instantiatePrefab, ale przez EntityPool - wcześniej zwolniona instancja jest używana ponownie.
+    // Prefab podany jako wskaźnik z Scene::findPrefab, bez nazwy do kopiowania i wyszukiwania przy playback.
+    void acquirePooled(const PrefabTemplate* prefab, EntityID parent = (EntityID)-1, SpawnCallback onSpawned = nullptr);
+
+    template<typename T>
+    void addComponent(EntityID id, const T& value = T{}) {
+        getQueue<T>().adds.emplace_back(id, value);
+    }
+
+    template<typename T>
+    void removeComponent(EntityID id) {
+        getQueue<T>().removes.push_back(id);
+    }
+
+    // komendy dodane w trakcie playback (np. z SpawnCallback) wykonują się w tym samym wywołaniu
+    void playback();
+
+    bool empty() const;
+
+private:
+    struct IComponentQueue {
+        virtual ~IComponentQueue() = default;
+
+        virtual IComponentStorage* createStorage() const = 0;
+        virtual void applyAdds(IComponentStorage& storage, const EntityManager& entities, uint32_t tick) = 0;
+        virtual void applyRemoves(IComponentStorage* storage) = 0;
+        virtual bool hasAdds() const = 0;
+        virtual bool hasRemoves() const = 0;
+    };
+
+    template<typename T>
+    struct ComponentQueue : IComponentQueue {
+        std::vector<std::pair<EntityID, T>> adds;
+        std::vector<EntityID> removes;
+
+        IComponentStorage* createStorage() const override {
+            return new ComponentStorage<T>();
+        }
+
+        void applyAdds(IComponentStorage& storage, const EntityManager& entities, uint32_t tick) override {
+            auto& typed = static_cast<ComponentStorage<T>&>(storage);
+            for (auto& [id, value] : adds) {
+                // encja mogła zostać zniszczona albo dostać komponent bezpośrednio przed playback
+                if (entities.isAlive(id) && !typed.has(id)) {
+                    typed.add(id, value, tick);
+                }
+            }
+            adds.clear();
+        }
+
+        void applyRemoves(IComponentStorage* storage) override {
+            for (EntityID id : removes) {
+                if (storage && storage->has(id)) {
+                    storage->remove(id);
+                }
+            }
+            removes.clear();
+        }
+
+        bool hasAdds() const override { return !adds.empty(); }
+        bool hasRemoves() const override { return !removes.empty(); }
+    };
+
+    struct PendingEntity {
+        EntityID id;
+        EntityID parent;
+    };
+
+    struct PendingPrefab {
+        // nazwa dla instantiatePrefab, template dla acquirePooled (wtedy nazwa pusta)
+        std::string name;
+        const PrefabTemplate* pooledPrefab;
+        EntityID parent;
+        SpawnCallback onSpawned;
+    };
+
+    Scene* scene;
+
+    std::vector<PendingEntity> creates;
+    std::vector<PendingPrefab> prefabs;
+    std::vector<EntityID> destroys;
+    // komendy wykonywane w bieżącym playbackOnce() - zamieniane z powyższymi, żeby obie pary zachowały pojemność
+    std::vector<PendingEntity> playbackCreates;
+    std::vector<PendingPrefab> playbackPrefabs;
+    std::vector<EntityID> playbackDestroys;
+    // indeksowane przez componentTypeId<T>(), jak storage w Scene
+    std::vector<std::unique_ptr<IComponentQueue>> componentQueues;
+
+    template<typename T>
+    ComponentQueue<T>& getQueue() {
+        ComponentTypeID type = componentTypeId<T>();
+        if (type >= componentQueues.size()) {
+            componentQueues.resize(type + 1);
+        }
+        if (!componentQueues[type]) {
+            componentQueues[type] = std::make_unique<ComponentQueue<T>>();
+        }
+        return static_cast<ComponentQueue<T>&>(*componentQueues[type]);
+    }
+
+    void playbackOnce();
+};
+
+#endif //PBL_COMMANDBUFFER_H
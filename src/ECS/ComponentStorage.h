@@ -5,9 +5,29 @@
 #ifndef PBL_COMPONENTSTORAGE_H
 #define PBL_COMPONENTSTORAGE_H
 #include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
 
 #include "EntityManager.h"
-#define MAX_OBJECTS 1500
+
+using ComponentTypeID = uint32_t;
+
+namespace detail {
+    inline ComponentTypeID nextComponentTypeId() {
+        static std::atomic<ComponentTypeID> counter{ 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+// Gęste ID typu komponentu, nadawane przy pierwszym użyciu typu - indeks do płaskiej tablicy storage w Scene.
+template<typename T>
+ComponentTypeID componentTypeId() {
+    static const ComponentTypeID id = detail::nextComponentTypeId();
+    return id;
+}
 
 struct IComponentStorage {
     virtual ~IComponentStorage() = default;
@@ -16,29 +36,60 @@ struct IComponentStorage {
 
 	virtual bool has(EntityID id) const = 0;
     virtual void remove(EntityID id) = 0;
+    // usuwa komponenty wszystkich podanych encji (encje bez komponentu są pomijane)
+    virtual void removeMany(std::span<const EntityID> ids) = 0;
 };
 
+// Sparse set: gęsta tablica komponentów + stronicowany indeks encja -> pozycja.
+// Strony indeksu są alokowane dopiero przy pierwszym komponencie z danego zakresu ID.
 template<typename T>
 class ComponentStorage : public IComponentStorage {
 private:
-    uint16_t quantity = 0;
+    static constexpr uint32_t PAGE_SIZE = 4096;
+    static constexpr int32_t INVALID_INDEX = -1;
 
-public:
-    T components[MAX_OBJECTS];
-    int entityToIndex[MAX_OBJECTS];
+    std::vector<std::unique_ptr<int32_t[]>> sparsePages;
 
-    ComponentStorage() {
-        for (int i = 0; i < MAX_OBJECTS; i++) {
-            entityToIndex[i] = -1;
+    int32_t* findSlot(EntityID id) const {
+        uint32_t index = entityIndex(id);
+        uint32_t page = index / PAGE_SIZE;
+        if (page >= sparsePages.size() || !sparsePages[page]) {
+            return nullptr;
         }
+        return &sparsePages[page][index % PAGE_SIZE];
     }
 
-	ComponentStorage(const ComponentStorage& other) : quantity(other.quantity) {
-		for (int i = 0; i < quantity; i++) {
-			components[i] = other.components[i];
-		}
-		for (int i = 0; i < MAX_OBJECTS; i++) {
-			entityToIndex[i] = other.entityToIndex[i];
+    int32_t& getOrCreateSlot(EntityID id) {
+        uint32_t index = entityIndex(id);
+        uint32_t page = index / PAGE_SIZE;
+        if (page >= sparsePages.size()) {
+            sparsePages.resize(page + 1);
+        }
+        if (!sparsePages[page]) {
+            sparsePages[page] = std::make_unique<int32_t[]>(PAGE_SIZE);
+            std::fill_n(sparsePages[page].get(), PAGE_SIZE, INVALID_INDEX);
+        }
+        return sparsePages[page][index % PAGE_SIZE];
+    }
+
+    // tick ostatniej zmiany, równoległy do components (ten sam indeks gęsty)
+    std::vector<uint32_t> changeTicks;
+    // rośnie przy każdym add/remove - zmienia się wtedy kolejność/zestaw komponentów
+    uint32_t structureVersion = 0;
+
+public:
+    std::vector<T> components;
+
+    ComponentStorage() = default;
+
+	ComponentStorage(const ComponentStorage& other)
+		: changeTicks(other.changeTicks), structureVersion(other.structureVersion), components(other.components) {
+		sparsePages.resize(other.sparsePages.size());
+		for (size_t i = 0; i < other.sparsePages.size(); i++) {
+			if (other.sparsePages[i]) {
+				sparsePages[i] = std::make_unique<int32_t[]>(PAGE_SIZE);
+				std::copy_n(other.sparsePages[i].get(), PAGE_SIZE, sparsePages[i].get());
+			}
 		}
 	}
 
@@ -47,45 +98,135 @@ public:
 	}
 
     bool has(EntityID id) const {
-        return entityToIndex[id] != -1;
+        const int32_t* slot = findSlot(id);
+        // porównanie pełnego ID odrzuca nieaktualne uchwyty (inna wersja, ten sam indeks)
+        return slot && *slot != INVALID_INDEX && components[*slot].id == id;
     }
 
     T& get(EntityID id)  {
         assert(has(id) && "ComponentStorage: trying to get a non-existing component");
-        return components[entityToIndex[id]];
+        return components[*findSlot(id)];
+    }
+
+    const T& get(EntityID id) const {
+        assert(has(id) && "ComponentStorage: trying to get a non-existing component");
+        return components[*findSlot(id)];
     }
 
-    void add(EntityID id, const T& component) {
+    void add(EntityID id, const T& component, uint32_t tick = 0) {
         assert(!has(id) && "ComponentStorage: trying to add an already existing component");
 
-        components[quantity] = component;
-        components[quantity].id = id;  // upewniamy się, że id jest ustawione poprawnie
-        entityToIndex[id] = quantity;
-        quantity++;
+        getOrCreateSlot(id) = static_cast<int32_t>(components.size());
+        components.push_back(component);
+        components.back().id = id;  // upewniamy się, że id jest ustawione poprawnie
+        changeTicks.push_back(tick);
+        structureVersion++;
+    }
+
+    // dostęp do zapisu - oznacza komponent jako zmieniony w danym ticku
+    T& getForWrite(EntityID id, uint32_t tick) {
+        assert(has(id) && "ComponentStorage: trying to get a non-existing component");
+        int32_t idx = *findSlot(id);
+        changeTicks[idx] = tick;
+        return components[idx];
+    }
+
+    void markChanged(EntityID id, uint32_t tick) {
+        assert(has(id) && "ComponentStorage: trying to mark a non-existing component");
+        changeTicks[*findSlot(id)] = tick;
+    }
+
+    uint32_t getChangeTick(EntityID id) const {
+        assert(has(id) && "ComponentStorage: trying to get a non-existing component");
+        return changeTicks[*findSlot(id)];
+    }
+
+    bool changedSince(EntityID id, uint32_t tick) const {
+        return getChangeTick(id) > tick;
+    }
+
+    uint32_t getStructureVersion() const {
+        return structureVersion;
+    }
+
+    // pozycja w components albo -1; ważna do następnej zmiany structureVersion
+    int32_t indexOf(EntityID id) const {
+        return has(id) ? *findSlot(id) : INVALID_INDEX;
+    }
+
+    void markChangedAt(uint32_t index, uint32_t tick) {
+        changeTicks[index] = tick;
     }
 
     void remove(EntityID id) {
         assert(has(id) && "ComponentStorage: trying to remove a non-existing component");
 
-        int idx = entityToIndex[id];
-        int lastIdx = quantity - 1;
+        int32_t& slot = *findSlot(id);
+        int32_t idx = slot;
+        int32_t lastIdx = static_cast<int32_t>(components.size()) - 1;
+
+        if (idx != lastIdx) {
+            components[idx] = std::move(components[lastIdx]);  // przepisujemy ostatni komponent na miejsce usuwanego
+            changeTicks[idx] = changeTicks[lastIdx];
+            *findSlot(components[idx].id) = idx; // aktualizujemy indeks nowego komponentu na tym miejscu
+        }
+
+        slot = INVALID_INDEX;
+        components.pop_back();
+        changeTicks.pop_back();
+        structureVersion++;
+    }
+
+    void removeMany(std::span<const EntityID> ids) override {
+        // przy kilku encjach taniej jest przenieść ostatnie elementy niż przejść całą tablicę
+        if (ids.size() * 8 < components.size()) {
+            for (EntityID id : ids) {
+                if (has(id)) remove(id);
+            }
+            return;
+        }
 
-        components[idx] = components[lastIdx];  // przepisujemy ostatni komponent na miejsce usuwanego
-        entityToIndex[components[idx].id] = idx; // aktualizujemy indeks nowego komponentu na tym miejscu
+        bool removedAny = false;
+        for (EntityID id : ids) {
+            if (has(id)) {
+                *findSlot(id) = INVALID_INDEX;
+                removedAny = true;
+            }
+        }
+        if (!removedAny) return;
+
+        // jeden przebieg kompaktujący - pozostałe komponenty zachowują kolejność
+        int32_t write = 0;
+        for (int32_t read = 0; read < static_cast<int32_t>(components.size()); read++) {
+            int32_t& slot = *findSlot(components[read].id);
+            if (slot == INVALID_INDEX) continue;
+
+            if (write != read) {
+                components[write] = std::move(components[read]);
+                changeTicks[write] = changeTicks[read];
+                slot = write;
+            }
+            write++;
+        }
+        components.erase(components.begin() + write, components.end());
+        changeTicks.resize(write);
+        structureVersion++;
+    }
 
-        entityToIndex[id] = -1;
-        quantity--;
+    uint32_t getQuantity() const {
+        return static_cast<uint32_t>(components.size());
     }
 
-    uint16_t getQuantity() const {
-        return quantity;
+    void reserve(uint32_t capacity) {
+        components.reserve(capacity);
+        changeTicks.reserve(capacity);
     }
 
-    T* begin() { return components; }
-    T* end() { return components + quantity; }
+    T* begin() { return components.data(); }
+    T* end() { return components.data() + components.size(); }
 
-    const T* begin() const { return components; }
-    const T* end() const { return components + quantity; }
+    const T* begin() const { return components.data(); }
+    const T* end() const { return components.data() + components.size(); }
 };
 
 
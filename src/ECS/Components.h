@@ -39,20 +39,29 @@ struct ObjectInfoComponent {
 	EntityID id;
 };
 
+// Gorąca część transformu - tylko to, czego potrzebuje przeliczanie macierzy globalnych (bez wskaźników na stertę).
 struct Transform {
-    bool isStatic = true;
-
-    glm::vec3 translation = {0.0f, 0.0f, 0.0f};
+    glm::mat4 globalMatrix = glm::mat4(1.0f);
     glm::quat rotation = {1.0f, 0.0f, 0.0f, 0.0f};
-    glm::vec3 eulerRotation = glm::vec3(0.0f);
+    glm::vec3 translation = {0.0f, 0.0f, 0.0f};
     glm::vec3 scale = {1.0f, 1.0f, 1.0f};
-    glm::mat4 globalMatrix = glm::mat4(1.0f);
+    EntityID parent = (EntityID) -1;
 
+	EntityID id = (EntityID)-1;
+
+    bool isStatic = true;
     bool isDirty = true;
-    std::vector<EntityID> children;
-    EntityID parent = (EntityID) -1;
+    // false dla encji odłożonych do EntityPool - pomijane razem z poddrzewem
+    bool isActive = true;
+};
+// dwie linie cache - nowe pola rzadko czytane w update() idą do TransformInfoComponent
+static_assert(sizeof(Transform) <= 128, "Transform: hot transform data should fit in two cache lines");
 
-    std::string uuid;
+// Zimna część transformu: kolejność dzieci w grafie sceny i kąty Eulera (edytor, serializacja).
+// Każda encja z Transform ma też ten komponent.
+struct TransformInfoComponent {
+    glm::vec3 eulerRotation = glm::vec3(0.0f);
+    std::vector<EntityID> children;
 
 	EntityID id = (EntityID)-1;
 };
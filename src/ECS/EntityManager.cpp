@@ -1,40 +1,48 @@
 #include "EntityManager.h"
 #include <cassert>
-#include <algorithm>
-
-EntityManager::EntityManager() {
-    for (EntityID id = 0; id < MAX_ENTITIES; ++id) {
-        availableIDs.push(id);
-    }
-}
-
-EntityManager::EntityManager(const EntityManager& other) 
-    : aliveEntities(other.aliveEntities), 
-    availableIDs(other.availableIDs), 
-    entities(other.entities) {}
 
 EntityID EntityManager::createEntity() {
-    assert(!availableIDs.empty() && "Maximum number of entities reached!");
+    uint32_t index;
+    EntityID id;
 
-    EntityID id = availableIDs.front();
-    availableIDs.pop();
-    aliveEntities.set(id);
+    if (freeHead != NO_FREE_SLOT) {
+        index = freeHead;
+        freeHead = entityIndex(slots[index]);
+        id = makeEntityID(index, entityVersion(slots[index]));
+    } else {
+        assert(slots.size() < MAX_ENTITIES && "Maximum number of entities reached!");
+        index = static_cast<uint32_t>(slots.size());
+        id = makeEntityID(index, 0);
+        slots.push_back(id);
+        alivePositions.push_back(0);
+    }
+
+    slots[index] = id;
+    alivePositions[index] = static_cast<uint32_t>(entities.size());
 	entities.push_back(id);
     return id;
 }
 
 void EntityManager::destroyEntity(EntityID id) {
-    assert(id < MAX_ENTITIES && "Entity ID is out of range!");
-    assert(aliveEntities.test(id) && "Attempt to destroy a non-existent entity!");
+    assert(isAlive(id) && "Attempt to destroy a non-existent entity!");
+
+    uint32_t index = entityIndex(id);
 
-    aliveEntities.reset(id);
-    availableIDs.push(id);
-	std::erase(entities, id);
+    uint32_t position = alivePositions[index];
+    EntityID last = entities.back();
+    entities[position] = last;
+    alivePositions[entityIndex(last)] = position;
+    entities.pop_back();
+
+    uint32_t nextVersion = (entityVersion(id) + 1) & ENTITY_VERSION_MASK;
+    slots[index] = makeEntityID(freeHead, nextVersion);
+    freeHead = index;
 }
 
 bool EntityManager::isAlive(EntityID id) const {
-	if (id >= MAX_ENTITIES) {
+    uint32_t index = entityIndex(id);
+	if (index >= slots.size()) {
 		return false;
 	}
-    return aliveEntities.test(id);
-}
\ No newline at end of file
+    return slots[index] == id;
+}
@@ -1,18 +1,31 @@
 #ifndef PBL_ENTITYMANAGER_H
 #define PBL_ENTITYMANAGER_H
 
-#include <bitset>
-#include <queue>
 #include <iostream>
 #include <cstdint>
 #include <vector>
 
-constexpr size_t MAX_ENTITIES = 15000;
-using EntityID = std::uint16_t;
+// EntityID = 20 bitów indeksu + 12 bitów wersji.
+// Wersja rośnie przy każdym zniszczeniu encji, więc stare ID nie trafią w nową encję o tym samym indeksie.
+using EntityID = std::uint32_t;
+
+constexpr uint32_t ENTITY_INDEX_BITS = 20;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_VERSION_MASK = (1u << (32 - ENTITY_INDEX_BITS)) - 1;
+// ostatni indeks jest zarezerwowany, żeby (EntityID)-1 nigdy nie było poprawną encją
+constexpr size_t MAX_ENTITIES = ENTITY_INDEX_MASK;
+
+constexpr uint32_t entityIndex(EntityID id) { return id & ENTITY_INDEX_MASK; }
+constexpr uint32_t entityVersion(EntityID id) { return id >> ENTITY_INDEX_BITS; }
+constexpr EntityID makeEntityID(uint32_t index, uint32_t version) {
+    return (version << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
 class EntityManager {
 public:
-    EntityManager();
-	EntityManager(const EntityManager&);
+    EntityManager() = default;
+	EntityManager(const EntityManager&) = default;
+	EntityManager& operator=(const EntityManager&) = default;
 
     EntityID createEntity();
     void destroyEntity(EntityID id);
@@ -20,9 +33,14 @@ public:
 	const std::vector<EntityID>& getEntities() const { return entities; }
 
 private:
-    std::bitset<MAX_ENTITIES> aliveEntities;
-    std::queue<EntityID> availableIDs;
+    static constexpr uint32_t NO_FREE_SLOT = ENTITY_INDEX_MASK;
+
+    // żywa encja: jej aktualne ID; wolny slot: indeks następnego wolnego slotu + wersja do nadania
+    std::vector<EntityID> slots;
+    // pozycja żywej encji w `entities` (swap-remove przy usuwaniu)
+    std::vector<uint32_t> alivePositions;
 	std::vector<EntityID> entities;
+    uint32_t freeHead = NO_FREE_SLOT;
 };
 
-#endif //PBL_ENTITYMANAGER_H
\ No newline at end of file
+#endif //PBL_ENTITYMANAGER_H
@@ -0,0 +1,119 @@
+#include "EntityPool.h"
+
+#include <algorithm>
+
+#include "Scene.h"
+#include "PrefabTemplate.h"
+
+
+EntityPool::EntityPool(Scene* scene) : scene(scene)
+{
+}
+
+EntityPool::EntityPool(Scene* scene, const EntityPool& other)
+    : scene(scene), instances(other.instances), freeRoots(other.freeRoots)
+{
+}
+
+const std::vector<EntityID>& EntityPool::acquire(const PrefabTemplate* prefab, EntityID parent)
+{
+    static const std::vector<EntityID> empty;
+
+    if (!prefab)
+        return empty;
+
+    if (parent == (EntityID)-1)
+        parent = scene->getSceneRootEntity();
+
+    auto& roots = freeRoots[prefab];
+    while (!roots.empty())
+    {
+        EntityID root = roots.back();
+        roots.pop_back();
+
+        auto it = instances.find(root);
+        if (it == instances.end())
+            continue;
+        // część instancji (dziecko) zniszczona osobno - nie da się jej zresetować
+        Instance& instance = it->second;
+        if (!std::all_of(instance.entities.begin(), instance.entities.end(),
+            [&](EntityID id) { return scene->hasEntity(id); }))
+        {
+            instances.erase(it);
+            continue;
+        }
+
+        prefab->reset(*scene, instance.entities);
+        if (std::as_const(*scene).getComponent<Transform>(root).parent != parent)
+        {
+            scene->getTransformSystem().addChild(parent, root);
+        }
+        instance.active = true;
+        return instance.entities;
+    }
+
+    std::vector<EntityID> entities = prefab->instantiate(*scene, parent);
+    if (entities.empty())
+        return empty;
+
+    EntityID root = entities[0];
+    Instance& instance = instances[root];
+    instance.prefab = prefab;
+    instance.entities = std::move(entities);
+    instance.active = true;
+    return instance.entities;
+}
+
+void EntityPool::release(EntityID root)
+{
+    auto it = instances.find(root);
+    if (it == instances.end() || !it->second.active)
+        return;
+
+    Instance& instance = it->second;
+    if (!scene->hasEntity(root))
+    {
+        instances.erase(it);
+        return;
+    }
+
+    setActive(instance, false);
+    instance.active = false;
+    freeRoots[instance.prefab].push_back(root);
+}
+
+void EntityPool::onEntitiesDestroyed(std::span<const EntityID> ids)
+{
+    if (instances.empty())
+        return;
+
+    bool removedFree = false;
+    for (EntityID id : ids)
+    {
+        auto it = instances.find(id);
+        if (it == instances.end())
+            continue;
+        removedFree |= !it->second.active;
+        instances.erase(it);
+    }
+
+    // jedno przefiltrowanie list wolnych korzeni zamiast szukania każdego osobno
+    if (removedFree)
+    {
+        for (auto& [prefab, roots] : freeRoots)
+        {
+            std::erase_if(roots, [&](EntityID root) { return !instances.contains(root); });
+        }
+    }
+}
+
+void EntityPool::setActive(const Instance& instance, bool active) const
+{
+    for (EntityID id : instance.entities)
+    {
+        if (scene->hasEntity(id))
+        {
+            scene->getComponent<Transform>(id).isActive = active;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+#ifndef PBL_ENTITYPOOL_H
+#define PBL_ENTITYPOOL_H
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "EntityManager.h"
+
+class Scene;
+class PrefabTemplate;
+
+// Pula instancji prefabów dla często tworzonych i niszczonych obiektów (np. ślady masła).
+// Zwolniona instancja zostaje w scenie z Transform::isActive = false - pomijana przez TransformSystem,
+// renderowanie, kolizje i systemy gry (Scene::isActive) - i przy następnym acquire() dostaje z powrotem wartości komponentów z prefabu.
+// Ponowne użycie nie tworzy encji, nie przesuwa komponentów w storage i nie generuje nowego uuid.
+class EntityPool {
+public:
+    explicit EntityPool(Scene* scene);
+    EntityPool(Scene* scene, const EntityPool& other);
+
+    EntityPool(const EntityPool&) = delete;
+    EntityPool& operator=(const EntityPool&) = delete;
+    EntityPool(EntityPool&&) = default;
+    EntityPool& operator=(EntityPool&&) = default;
+
+    // encje instancji (pierwsza to korzeń prefabu); pusta lista dla nullptr (np. brak prefabu w Scene::findPrefab).
+    // Referencja ważna do usunięcia instancji z pooli (zniszczenie korzenia).
+    const std::vector<EntityID>& acquire(const PrefabTemplate* prefab, EntityID parent = (EntityID)-1);
+
+    // root musi pochodzić z acquire(); inne encje są ignorowane
+    void release(EntityID root);
+
+    // wołane przez Scene::destroyEntities - instancje zniszczone poza pulą są od razu usuwane
+    void onEntitiesDestroyed(std::span<const EntityID> ids);
+
+private:
+    struct Instance {
+        const PrefabTemplate* prefab;
+        std::vector<EntityID> entities;
+        bool active = true;
+    };
+
+    void setActive(const Instance& instance, bool active) const;
+
+    Scene* scene;
+
+    // korzeń -> instancja
+    std::unordered_map<EntityID, Instance> instances;
+    // prefab -> korzenie wolnych instancji
+    std::unordered_map<const PrefabTemplate*, std::vector<EntityID>> freeRoots;
+};
+
+#endif //PBL_ENTITYPOOL_H
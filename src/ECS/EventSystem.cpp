@@ -3,3 +3,49 @@
 //
 
 #include "EventSystem.h"
+
+#include <cstdlib>
+#include <spdlog/spdlog.h>
+
+namespace detail {
+
+    namespace {
+        struct EventThreadSlotPool {
+            std::mutex mutex;
+            std::vector<uint32_t> freeSlots;
+            uint32_t nextSlot = 0;
+        };
+
+        // Celowo nigdy nie niszczona - wątki robocze singletonów (JobSystem) kończą się przy niszczeniu
+        // obiektów statycznych i zwalniają sloty po tym, jak zwykła zmienna statyczna już by nie istniała.
+        EventThreadSlotPool& slotPool() {
+            static EventThreadSlotPool* pool = new EventThreadSlotPool();
+            return *pool;
+        }
+    }
+
+    EventThreadSlot::EventThreadSlot() {
+        auto& pool = slotPool();
+        std::lock_guard lock(pool.mutex);
+        if (!pool.freeSlots.empty()) {
+            index = pool.freeSlots.back();
+            pool.freeSlots.pop_back();
+            return;
+        }
+
+        // również w wydaniu - indeks poza tablicą buforów pisałby po pamięci kanału
+        if (pool.nextSlot >= MAX_EVENT_THREADS) {
+            spdlog::critical("EventSystem: more than {} live threads queueing events", MAX_EVENT_THREADS);
+            std::abort();
+        }
+        index = pool.nextSlot++;
+    }
+
+    // bufory slotu zostają w kanałach - niescalone zdarzenia zakończonego wątku trafią do processEvents
+    EventThreadSlot::~EventThreadSlot() {
+        auto& pool = slotPool();
+        std::lock_guard lock(pool.mutex);
+        pool.freeSlots.push_back(index);
+    }
+
+}
@@ -7,13 +7,17 @@
 
 
 
-#include <functional>
-#include <queue>
-#include <unordered_map>
-#include <vector>
-#include <typeindex>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
 #include <memory>
-#include <iostream>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "Delegate.h"
 
 // Bazowa klasa zdarzenia
 class Event {
@@ -22,13 +26,324 @@ public:
 };
 
 
-using EventListener = std::function<void(const Event&)>;
+using EventListener = Delegate<void(const Event&)>;
+
+// Listener wywoływany raz na processEvents() ze wszystkimi zdarzeniami danego typu
+template<typename EventType>
+using BatchEventListener = Delegate<void(std::span<const EventType>)>;
+
+// Zwracany przy rejestracji listenera, służy do jego usunięcia
+struct ListenerHandle {
+    uint32_t type = (uint32_t)-1;
+    uint32_t slot = 0;
+    uint32_t generation = 0;
+    bool batch = false;
+
+    bool isValid() const { return type != (uint32_t)-1; }
+};
+
+// Listenery w kolejności rejestracji. Usunięcie przez uchwyt w O(1) - wpis tylko oznaczany,
+// tablica zagęszczana przy następnym przejściu. Sloty uchwytów i bufory są używane ponownie.
+template<typename Listener>
+class ListenerList {
+public:
+    // slot i generacja dla ListenerHandle
+    std::pair<uint32_t, uint32_t> add(Listener listener) {
+        uint32_t slot;
+        if (!freeSlots.empty()) {
+            slot = freeSlots.back();
+            freeSlots.pop_back();
+        } else {
+            slot = static_cast<uint32_t>(slots.size());
+            slots.push_back({});
+        }
+        // w trakcie forEach entries nie może się realokować - wykonywany listener leży w tej tablicy.
+        // Nowe wpisy czekają w pending (indeksy za końcem entries) do końca przejścia.
+        slots[slot].entry = static_cast<uint32_t>(entries.size() + pending.size());
+        if (iterating > 0)
+            pending.push_back({ std::move(listener), slot, false });
+        else
+            entries.push_back({ std::move(listener), slot, false });
+        return { slot, slots[slot].generation };
+    }
+
+    bool remove(uint32_t slot, uint32_t generation) {
+        if (slot >= slots.size() || slots[slot].generation != generation)
+            return false;
+
+        uint32_t position = slots[slot].entry;
+        Entry& entry = position < entries.size() ? entries[position] : pending[position - entries.size()];
+        entry.removed = true;
+        // nie niszczymy od razu - listener może być właśnie wykonywany
+        removedCount++;
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+        return true;
+    }
+
+    bool empty() const { return entries.size() + pending.size() == removedCount; }
+
+    template<typename Function>
+    void forEach(Function&& function) {
+        if (removedCount > 0 && iterating == 0)
+            compact();
+
+        iterating++;
+        // listenery dodane w trakcie przejścia czekają do następnego
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (!entries[i].removed)
+                function(entries[i].listener);
+        }
+        iterating--;
+
+        if (iterating == 0 && !pending.empty())
+            flushPending();
+    }
+
+private:
+    struct Entry {
+        Listener listener;
+        uint32_t slot;
+        bool removed;
+    };
+
+    struct Slot {
+        uint32_t entry = 0;
+        uint32_t generation = 0;
+    };
+
+    std::vector<Entry> entries;
+    // dodane w trakcie forEach
+    std::vector<Entry> pending;
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    uint32_t removedCount = 0;
+    uint32_t iterating = 0;
+
+    // indeksy slotów się nie zmieniają - wpisy z pending już wskazywały za koniec entries
+    void flushPending() {
+        for (Entry& entry : pending) {
+            entries.push_back(std::move(entry));
+        }
+        pending.clear();
+    }
+
+    void compact() {
+        size_t kept = 0;
+        for (size_t i = 0; i < entries.size(); i++) {
+            if (entries[i].removed)
+                continue;
+            if (kept != i)
+                entries[kept] = std::move(entries[i]);
+            slots[entries[kept].slot].entry = static_cast<uint32_t>(kept);
+            kept++;
+        }
+        entries.erase(entries.begin() + kept, entries.end());
+        removedCount = 0;
+    }
+};
+
+namespace detail {
+    inline uint32_t nextEventTypeId() {
+        static std::atomic<uint32_t> counter{ 0 };
+        return counter.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // maksymalna liczba jednocześnie żyjących wątków wysyłających zdarzenia przez queueEventConcurrent
+    constexpr uint32_t MAX_EVENT_THREADS = 64;
+
+    // Slot bufora zdarzeń zajęty przez wątek do jego zakończenia, potem wraca do puli - restart
+    // workerów (JobSystem::setThreadCount) nie wyczerpuje slotów. Przekroczenie limitu przerywa program.
+    struct EventThreadSlot {
+        uint32_t index;
+
+        EventThreadSlot();
+        ~EventThreadSlot();
+    };
+
+    // indeks bufora zdarzeń bieżącego wątku w każdym kanale
+    inline uint32_t eventThreadIndex() {
+        static thread_local EventThreadSlot slot;
+        return slot.index;
+    }
+}
+
+// Gęste ID typu zdarzenia (jak componentTypeId) - indeks kanału w EventSystem
+template<typename EventType>
+uint32_t eventTypeId() {
+    static const uint32_t id = detail::nextEventTypeId();
+    return id;
+}
 
 
+// Każdy typ zdarzenia ma własny kanał: listenery i kolejkę zdarzeń w ciągłej tablicy.
+// Bufory kolejek są używane ponownie, więc po rozgrzaniu kolejkowanie nie alokuje.
+// processEvents() zachowuje kolejność w obrębie typu; typy obsługiwane są w kolejności pierwszego zdarzenia.
 class EventSystem {
 private:
-    std::unordered_map<std::type_index, std::vector<EventListener>> listeners;
-    std::queue<std::unique_ptr<Event>> eventQueue;
+    struct IEventChannel {
+        virtual ~IEventChannel() = default;
+        virtual void dispatch() = 0;
+        virtual bool removeBatchListener(uint32_t slot, uint32_t generation) = 0;
+        // przenosi zdarzenia z buforów wątków do kolejki; true, jeśli kanał trzeba dopisać do pendingChannels
+        virtual bool mergeConcurrent() = 0;
+        virtual void clearQueued() = 0;
+
+        ListenerList<EventListener> listeners;
+        std::atomic<bool> hasConcurrent{ false };
+    };
+
+    template<typename EventType>
+    struct EventChannel : IEventChannel {
+        std::vector<EventType> queued;
+        // zdarzenia w trakcie obsługi - listener może dokolejkować nowe tego samego typu
+        std::vector<EventType> processing;
+        ListenerList<BatchEventListener<EventType>> batchListeners;
+
+        struct KeyedEvent {
+            uint64_t key;
+            EventType event;
+        };
+
+        // bufor jednego wątku - zapisywany tylko przez ten wątek, czytany w processEvents
+        struct ThreadBuffer {
+            std::vector<KeyedEvent> events;
+        };
+
+        std::array<std::atomic<ThreadBuffer*>, detail::MAX_EVENT_THREADS> threadBuffers{};
+        std::vector<std::unique_ptr<ThreadBuffer>> ownedBuffers;
+        std::mutex buffersMutex;
+
+        // sortowane są małe wpisy, zdarzenia przenoszone raz - prosto z bufora do kolejki
+        struct MergeEntry {
+            uint64_t key;
+            uint32_t buffer;
+            uint32_t position;
+
+            bool operator<(const MergeEntry& other) const {
+                if (key != other.key) return key < other.key;
+                if (buffer != other.buffer) return buffer < other.buffer;
+                return position < other.position;
+            }
+        };
+        std::vector<MergeEntry> merged;
+        std::vector<ThreadBuffer*> mergedBuffers;
+
+        ThreadBuffer& localBuffer() {
+            auto& slot = threadBuffers[detail::eventThreadIndex()];
+            ThreadBuffer* buffer = slot.load(std::memory_order_acquire);
+            if (!buffer) {
+                // tylko przy pierwszym zdarzeniu z danego wątku
+                std::lock_guard lock(buffersMutex);
+                ownedBuffers.push_back(std::make_unique<ThreadBuffer>());
+                buffer = ownedBuffers.back().get();
+                slot.store(buffer, std::memory_order_release);
+            }
+            return *buffer;
+        }
+
+        // Kolejność po scaleniu zależy tylko od kluczy: rosnąco, a przy równych kluczach w kolejności
+        // wysłania. Równe klucze muszą więc pochodzić z jednego wątku (np. klucz = system + encja).
+        bool mergeConcurrent() override {
+            if (!hasConcurrent.exchange(false, std::memory_order_acquire))
+                return false;
+
+            merged.clear();
+            mergedBuffers.clear();
+            bool runsSorted = true;
+            for (auto& slot : threadBuffers) {
+                ThreadBuffer* buffer = slot.load(std::memory_order_acquire);
+                if (!buffer || buffer->events.empty()) continue;
+                uint32_t bufferIndex = static_cast<uint32_t>(mergedBuffers.size());
+                mergedBuffers.push_back(buffer);
+                size_t runBegin = merged.size();
+                for (uint32_t position = 0; position < buffer->events.size(); position++) {
+                    merged.push_back({ buffer->events[position].key, bufferIndex, position });
+                }
+                runsSorted = runsSorted && std::is_sorted(merged.begin() + runBegin, merged.end());
+                // wątki zwykle wysyłają rosnącymi kluczami - wtedy wystarczy scalić posortowane serie
+                if (runsSorted && runBegin > 0) {
+                    std::inplace_merge(merged.begin(), merged.begin() + runBegin, merged.end());
+                }
+            }
+            // pozycja w buforze rozstrzyga równe klucze - kolejność wysłania z tego wątku
+            if (!runsSorted) {
+                std::sort(merged.begin(), merged.end());
+            }
+
+            bool wasEmpty = queued.empty();
+            for (const MergeEntry& entry : merged) {
+                queued.push_back(std::move(mergedBuffers[entry.buffer]->events[entry.position].event));
+            }
+            for (ThreadBuffer* buffer : mergedBuffers) {
+                buffer->events.clear();
+            }
+            merged.clear();
+            return wasEmpty && !queued.empty();
+        }
+
+        // najpierw zwykłe listenery zdarzenie po zdarzeniu, potem listenery wsadowe z całą tablicą
+        void dispatch() override {
+            processing.swap(queued);
+            if (!listeners.empty()) {
+                for (const EventType& event : processing) {
+                    listeners.forEach([&](const EventListener& listener) { listener(event); });
+                }
+            }
+            batchListeners.forEach([&](const BatchEventListener<EventType>& listener) {
+                listener(std::span<const EventType>(processing));
+            });
+            processing.clear();
+        }
+
+        void clearQueued() override {
+            queued.clear();
+            hasConcurrent.store(false, std::memory_order_relaxed);
+            for (auto& slot : threadBuffers) {
+                if (ThreadBuffer* buffer = slot.load(std::memory_order_acquire))
+                    buffer->events.clear();
+            }
+        }
+
+        bool removeBatchListener(uint32_t slot, uint32_t generation) override {
+            return batchListeners.remove(slot, generation);
+        }
+    };
+
+    // indeksowane przez eventTypeId<T>()
+    std::vector<std::unique_ptr<IEventChannel>> channels;
+    // kanały z niepustą kolejką, w kolejności pierwszego zdarzenia
+    std::vector<uint32_t> pendingChannels;
+    std::vector<uint32_t> processingChannels;
+
+    template<typename EventType>
+    EventChannel<EventType>& getChannel() {
+        uint32_t type = eventTypeId<EventType>();
+        if (type >= channels.size()) {
+            channels.resize(type + 1);
+        }
+        if (!channels[type]) {
+            channels[type] = std::make_unique<EventChannel<EventType>>();
+        }
+        return static_cast<EventChannel<EventType>&>(*channels[type]);
+    }
+
+    template<typename EventType>
+    EventChannel<EventType>* findChannel() const {
+        uint32_t type = eventTypeId<EventType>();
+        if (type >= channels.size()) return nullptr;
+        return static_cast<EventChannel<EventType>*>(channels[type].get());
+    }
+
+    template<typename EventType>
+    void pushQueued(EventType&& event) {
+        using Type = std::decay_t<EventType>;
+        auto& channel = getChannel<Type>();
+        if (channel.queued.empty()) {
+            pendingChannels.push_back(eventTypeId<Type>());
+        }
+        channel.queued.push_back(std::forward<EventType>(event));
+    }
 
 public:
     EventSystem() = default;
@@ -37,52 +352,95 @@ public:
     EventSystem(EventSystem&&) = default; // Przenoszenie dozwolone
     EventSystem& operator=(EventSystem&&) = default;
     template<typename EventType>
-    void registerListener(EventListener listener) {
-        listeners[std::type_index(typeid(EventType))].push_back(std::move(listener));
+    ListenerHandle registerListener(EventListener listener) {
+        auto [slot, generation] = getChannel<EventType>().listeners.add(std::move(listener));
+        return { eventTypeId<EventType>(), slot, generation, false };
     }
 
-	template<typename EventType>
-	void unregisterListener(EventListener listener) {
-		auto it = listeners.find(std::type_index(typeid(EventType)));
-		if (it != listeners.end()) {
-			auto& vec = it->second;
-			vec.erase(std::remove_if(vec.begin(), vec.end(),
-				[&listener](const EventListener& l) { return l.target<void(const Event&)>() == listener.target<void(const Event&)>(); }),
-				vec.end());
-		}
-	}
+    template<typename EventType>
+    ListenerHandle registerBatchListener(BatchEventListener<EventType> listener) {
+        auto [slot, generation] = getChannel<EventType>().batchListeners.add(std::move(listener));
+        return { eventTypeId<EventType>(), slot, generation, true };
+    }
+
+    // false, jeśli listener był już usunięty
+    bool unregisterListener(ListenerHandle& handle) {
+        if (!handle.isValid() || handle.type >= channels.size() || !channels[handle.type])
+            return false;
+
+        auto& channel = *channels[handle.type];
+        bool removed = handle.batch
+            ? channel.removeBatchListener(handle.slot, handle.generation)
+            : channel.listeners.remove(handle.slot, handle.generation);
+        handle = {};
+        return removed;
+    }
 
     template<typename EventType>
     void triggerEvent(const EventType& event) {
-        auto it = listeners.find(std::type_index(typeid(EventType)));
-        if (it != listeners.end()) {
-            for (auto& listener : it->second) {
-                listener(event);
-            }
+        if (auto channel = findChannel<EventType>()) {
+            channel->listeners.forEach([&](const EventListener& listener) { listener(event); });
+            channel->batchListeners.forEach([&](const BatchEventListener<EventType>& listener) {
+                listener(std::span<const EventType>(&event, 1));
+            });
         }
     }
 
     template<typename EventType, typename... Args>
     void queueEvent(Args&&... args) {
-        eventQueue.push(std::make_unique<EventType>(std::forward<Args>(args)...));
+        pushQueued(EventType(std::forward<Args>(args)...));
     }
 
     template<typename EventType>
     void queueEvent(EventType event) {
-        eventQueue.push(std::make_unique<EventType>(std::move(event)));
+        pushQueued(std::move(event));
+    }
+
+    // Kolejkowanie z wielu wątków naraz (systemy w SystemScheduler, zadania JobSystem) - każdy wątek
+    // dopisuje do własnego bufora, bez blokady. processEvents() scala bufory według orderKey,
+    // więc kolejność nie zależy od przydziału zadań do wątków.
+    // Kanał musi już istnieć (registerListener/prepareChannel) - w trakcie pracy wątków tablica kanałów się nie zmienia.
+    template<typename EventType>
+    void queueEventConcurrent(uint64_t orderKey, EventType event) {
+        auto channel = findChannel<EventType>();
+        assert(channel && "EventSystem: queueEventConcurrent without prepared channel");
+        if (!channel) return;
+
+        channel->localBuffer().events.push_back({ orderKey, std::move(event) });
+        // bez zapisu, jeśli flaga już ustawiona - wątki nie przerzucają się linią cache
+        if (!channel->hasConcurrent.load(std::memory_order_relaxed))
+            channel->hasConcurrent.store(true, std::memory_order_release);
+    }
+
+    // tworzy kanał z wyprzedzeniem, na wątku głównym
+    template<typename EventType>
+    void prepareChannel() {
+        getChannel<EventType>();
+    }
+
+    // odrzuca zdarzenia czekające na processEvents() (np. po przywróceniu sceny); listenery i bufory zostają
+    void clearQueued() {
+        assert(processingChannels.empty() && "EventSystem: clearQueued during processEvents");
+        for (auto& channel : channels) {
+            if (channel) channel->clearQueued();
+        }
+        pendingChannels.clear();
     }
 
     void processEvents() {
-        while (!eventQueue.empty()) {
-            auto event = std::move(eventQueue.front());
-            eventQueue.pop();
-
-            auto it = listeners.find(std::type_index(typeid(*event)));
-            if (it != listeners.end()) {
-                for (auto& listener : it->second) {
-                    listener(*event);
-                }
+        // zdarzenia z wątków trafiają na koniec kolejek, po zdarzeniach z queueEvent
+        for (uint32_t type = 0; type < channels.size(); type++) {
+            if (channels[type] && channels[type]->mergeConcurrent()) {
+                pendingChannels.push_back(type);
+            }
+        }
+
+        while (!pendingChannels.empty()) {
+            processingChannels.swap(pendingChannels);
+            for (uint32_t type : processingChannels) {
+                channels[type]->dispatch();
             }
+            processingChannels.clear();
         }
     }
 };
@@ -9,16 +9,14 @@
 
 FlyAISystem::FlyAISystem(Scene* scene) : scene(scene) {}
 
-void FlyAISystem::update() {
-	auto transforms = scene->getStorage<Transform>();
-	auto flyAIComponents = scene->getStorage<FlyAIComponent>();
-    if (!flyAIComponents)
-		return;
-	for (int i = 0; i < flyAIComponents->getQuantity(); i++) {
-		auto& flyAI = flyAIComponents->components[i];
-		auto& transform = transforms->get(flyAI.id);
+void FlyAISystem::update(TransformWriteQueue& transformWrites) {
+	this->transformWrites = &transformWrites;
+
+	auto transforms = std::as_const(*scene).getStorage<Transform>();
+	scene->view<FlyAIComponent, Transform>().each([&](EntityID, FlyAIComponent& flyAI, const Transform& transform) {
+		if (!transform.isActive) return;
 		FlyAIAndTransform flyComp{ flyAI, transform };
-		if (flyAI.idButter == (EntityID)-1) continue;
+		if (!scene->hasEntity(flyAI.idButter)) return;
         if (flyAI.diveCooldownTimer > 0.f)
             flyAI.diveCooldownTimer -= deltaTime;
 
@@ -53,13 +51,14 @@ void FlyAISystem::update() {
             }
             break;
         }
-	}
+	});
+
+	this->transformWrites = nullptr;
 }
 
 void FlyAISystem::patrol(const FlyAIAndTransform& flyComp, float patrolHeight) {
     auto& transform = flyComp.transform;
     auto& flyAI = flyComp.flyAI;
-    auto& ts = scene->getTransformSystem();
 
     glm::vec3 currentPosition = glm::vec3(transform.globalMatrix[3]);
     glm::vec3 direction = glm::normalize(flyAI.patrolTarget - currentPosition);
@@ -68,7 +67,7 @@ void FlyAISystem::patrol(const FlyAIAndTransform& flyComp, float patrolHeight) {
     glm::vec3 newPosition = currentPosition + direction * flyAI.patrolSpeed * deltaTime;
     newPosition.y = patrolHeight;
 
-    ts.translateEntity(flyAI.id, newPosition);
+    transformWrites->translate(flyAI.id, newPosition);
     lookAt2D(flyComp, flyAI.patrolTarget);
 
     if (glm::distance(newPosition, flyAI.patrolTarget) < flyAI.patrolPointReachedThreshold) {
@@ -82,14 +81,13 @@ void FlyAISystem::lookAt2D(const FlyAIAndTransform& flyComp, glm::vec3 target)
 {
     auto& transform = flyComp.transform;
     auto& flyAI = flyComp.flyAI;
-    auto& ts = scene->getTransformSystem();
 	glm::vec3 dir = target - glm::vec3(transform.globalMatrix[3]);
     dir.y = 0;
 	dir = glm::normalize(dir);
     if (dir != glm::vec3(0))
     {
         glm::quat rot = glm::quatLookAt(-dir, glm::vec3(0,1,0));
-        ts.rotateEntity(flyAI.id, glm::slerp(transform.rotation, rot, deltaTime * 5.f));
+        transformWrites->rotate(flyAI.id, glm::slerp(transform.rotation, rot, deltaTime * 5.f));
     }
 }
 
@@ -126,8 +124,7 @@ void FlyAISystem::dive(const FlyAIAndTransform& flyComp)
 {
     auto& transform = flyComp.transform;
     auto& flyAI = flyComp.flyAI;
-	auto& butter = scene->getStorage<Transform>()->get(flyAI.idButter);
-    auto& ts = scene->getTransformSystem();
+	const auto& butter = std::as_const(*scene).getComponent<Transform>(flyAI.idButter);
 	glm::vec4 butterPos = butter.globalMatrix[3];
 	if (butterPos.y <= flyAI.diveEndHeight)
 	{
@@ -136,8 +133,9 @@ void FlyAISystem::dive(const FlyAIAndTransform& flyComp)
 	glm::vec4 direction = butterPos - transform.globalMatrix[3];
     direction.w = 0.0f;
     direction = glm::normalize(direction);
-    transform.globalMatrix[3] += direction * flyAI.diveSpeed * deltaTime;
-    ts.setGlobalMatrix(flyAI.id, transform.globalMatrix);
+    glm::mat4 globalMatrix = transform.globalMatrix;
+    globalMatrix[3] += direction * flyAI.diveSpeed * deltaTime;
+    transformWrites->setGlobalMatrix(flyAI.id, globalMatrix);
     lookAt2D(flyComp, butter.globalMatrix[3]);
 }
 
@@ -145,14 +143,14 @@ void FlyAISystem::returnToPatrolHeight(const FlyAIAndTransform& flyComp, float p
 {
     auto& transform = flyComp.transform;
     auto& flyAI = flyComp.flyAI;
-    auto& ts = scene->getTransformSystem();
 	glm::vec3 target = transform.globalMatrix[3];
 	target.y = patrolHeight;
 	glm::vec3 direction = glm::vec3(target - glm::vec3(transform.globalMatrix[3]));
     direction = glm::normalize(direction);
 	glm::vec3 position = transform.globalMatrix[3];
 	position += direction * flyAI.returnSpeed * deltaTime;
-	transform.globalMatrix[3] = glm::vec4(position, 0.0f);
-    ts.setGlobalMatrix(flyAI.id, transform.globalMatrix);
+	glm::mat4 globalMatrix = transform.globalMatrix;
+	globalMatrix[3] = glm::vec4(position, 0.0f);
+    transformWrites->setGlobalMatrix(flyAI.id, globalMatrix);
     lookAt2D(flyComp, flyAI.patrolTarget);
 }
\ No newline at end of file
@@ -1,22 +1,28 @@
 #pragma once
+#include <vector>
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "EntityManager.h"
 class Scene;
 struct FlyAIComponent;
 struct Transform;
+class TransformWriteQueue;
 class FlyAISystem {
 private:
 	struct FlyAIAndTransform {
 		FlyAIComponent& flyAI;
-		Transform& transform;
+		const Transform& transform;
 	};
 	Scene* scene;
+	// kolejka z bieżącego update() - transformy much zmienia dopiero TransformSystem::update()
+	TransformWriteQueue* transformWrites = nullptr;
 	void patrol(const FlyAIAndTransform& flyComp, float patrolHeight);
 	void chooseNewPatrolPoint(const FlyAIAndTransform& flyComp);
 	void dive(const FlyAIAndTransform& flyComp);
 	void returnToPatrolHeight(const FlyAIAndTransform& flyComp, float patrolHeight);
 	void lookAt2D(const FlyAIAndTransform& flyComp, glm::vec3 target);
 public:
-	void update();
+	void update(TransformWriteQueue& transformWrites);
 	FlyAISystem(Scene* scene);
 	float deltaTime;
 };
\ No newline at end of file
@@ -4,60 +4,24 @@
 
 #include "RenderingSystem.h"
 #include "Model.h"
-#include "stb_image.h"
 #include "glm/gtc/matrix_transform.hpp"
 #include "Scene.h"
 #include "spdlog/spdlog.h"
 #include "glm/gtc/type_ptr.hpp"
 #include <unordered_set>
 
-#include "Random.h"
-
-
-static std::array<glm::vec3, 16> generateSSAONoise() {
-    std::array<glm::vec3, 16> noise;
-    for (int i = 0; i < 16; ++i) {
-        glm::vec3 v = {
-            Random::getFloat(-1.0f, 1.0f),
-            Random::getFloat(-1.0f, 1.0f),
-            0.0f
-        };
-        noise[i] = glm::normalize(v);
-    }
-
-	return noise;
-}
-
+#include "Renderer.h"
 
 
 RenderingSystem::RenderingSystem(Scene *scene) : scene(scene) 
 {
-	glBindTexture(GL_TEXTURE_2D, shadowFramebuffer.GetDepthTexture());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-	GLfloat borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
-	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
-
-	ssaoNoise = generateSSAONoise();
-
-	glGenTextures(1, &ssaoNoiseTexture);
-	glBindTexture(GL_TEXTURE_2D, ssaoNoiseTexture);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, 4, 4, 0, GL_RGB, GL_FLOAT, ssaoNoise.data());
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 }
 
-RenderingSystem::~RenderingSystem()
-{
-	glDeleteTextures(1, &ssaoNoiseTexture);
-}
-
-void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1, Camera* cameraP2, const UniformBlockStorage& uniformBlockStorage,
+void RenderingSystem::drawScene(Renderer& renderer, const Framebuffer& framebuffer, Camera& cameraP1, Camera* cameraP2, const UniformBlockStorage& uniformBlockStorage,
     const std::unordered_map<std::string, Shader*>& postShaders) 
 {
-    auto models = scene->getStorage<ModelComponent>();
+    refreshTree();
+
     auto transforms = scene->getStorage<Transform>();
     auto lights = scene->getStorage<DirectionalLightComponent>();
     DirectionalLightComponent mainLight;
@@ -80,10 +44,7 @@ void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1
 		customFramebufferPtr = &normalFramebuffer;
 	}
 	CustomFramebuffer& customFramebuffer = *customFramebufferPtr;*/
-	auto [fboWidth, fboHeight] = customFramebuffer.GetSizePair();
-	if (fboWidth != width || fboHeight != height) {
-		customFramebuffer.Resize(width, height);
-	}
+	renderer.resizeTargets(width, height);
 	
 
 	Shader* shadowShader = postShaders.at("ShadowMap");
@@ -96,7 +57,7 @@ void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1
         glm::vec3 lightPos = transforms->get(mainLight.id).translation;
         glm::mat4 lightProjection = glm::ortho(-30.0f, 30.0f, -30.0f, 30.0f, 1.0f, 60.0f);
         glm::mat4 lightView = glm::inverse(transforms->get(mainLight.id).globalMatrix);
-        shadowFramebuffer.Bind();
+        renderer.shadowFramebuffer.Bind();
         glClear(GL_DEPTH_BUFFER_BIT);
         shadowShader->use();
         shadowShader->setMat4("lightProjection", lightProjection);
@@ -105,15 +66,14 @@ void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1
         uniformBlockStorage.cameraBlock.setData("lightView", &lightView);
         shadowShader->setVec3("lightPos", lightPos);
 
-        for (int i = 0; i < models->getQuantity(); i++) {
-            auto& modelComponent = models->components[i];
-
-            shadowShader->setMat4("model", transforms->get(modelComponent.id).globalMatrix);
+        scene->view<ModelComponent, Transform>().each([&](EntityID, ModelComponent& modelComponent, Transform& transform) {
+            if (!transform.isActive) return;
+            shadowShader->setMat4("model", transform.globalMatrix);
             modelComponent.model->draw(shadowShader);
-        }
+        });
 
 		Shader* ShadowFXAAShader = postShaders.at("ShadowFXAA");
-		shadowFxaaFilter(ShadowFXAAShader, shadowFramebuffer, shadowPostFramebuffer);
+		renderer.shadowFxaaFilter(ShadowFXAAShader, renderer.shadowFramebuffer, renderer.shadowPostFramebuffer);
 
 	}
     //##############################################
@@ -129,31 +89,22 @@ void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1
     glm::mat4 projectionMatrix = frustum.getProjectionMatrix();
     glm::mat4 viewProjectionMatrix = projectionMatrix * viewMatrix;
 
-	std::array auxBuffers = { &auxiliaryFramebuffer1, &auxiliaryFramebuffer2,
-        &postProcessingFramebuffer1, &postProcessingFramebuffer2, &ssaoFramebuffer };
-	for (auto& auxBuffer : auxBuffers) {
-		auto [pfboWidth, pfboHeight] = auxBuffer->GetSizePair();
-		if (pfboWidth != width || pfboHeight != height) {
-            auxBuffer->Resize(width, height);
-		}
-	}
-
     CustomFramebuffer* baseOutputFramebuffer;
 
 	if (cameraP2 != nullptr) {
-		drawBase(auxiliaryFramebuffer1, cameraP1, uniformBlockStorage, postShaders, useShadows);
+		drawBase(renderer, renderer.auxiliaryFramebuffer1, cameraP1, uniformBlockStorage, postShaders, useShadows);
 		glm::mat4 viewMatrixP2 = cameraP2->getViewMatrix();
 		glm::mat4 projectionMatrixP2 = cameraP2->getFrustum().getProjectionMatrix();
 		glm::mat4 viewProjectionMatrixP2 = projectionMatrixP2 * viewMatrixP2;
 
-		drawBase(auxiliaryFramebuffer2, *cameraP2, uniformBlockStorage, postShaders, useShadows);
+		drawBase(renderer, renderer.auxiliaryFramebuffer2, *cameraP2, uniformBlockStorage, postShaders, useShadows);
 
-		baseOutputFramebuffer = &postProcessingFramebuffer1;
-		dynamicSplitScreen(postShaders.at("SplitScreen"), cameraP1, auxiliaryFramebuffer1, auxiliaryFramebuffer2, *baseOutputFramebuffer);
+		baseOutputFramebuffer = &renderer.postProcessingFramebuffer1;
+		renderer.dynamicSplitScreen(postShaders.at("SplitScreen"), cameraP1, renderer.auxiliaryFramebuffer1, renderer.auxiliaryFramebuffer2, *baseOutputFramebuffer);
 	}
 	else {
-		baseOutputFramebuffer = &auxiliaryFramebuffer1;
-		drawBase(*baseOutputFramebuffer, cameraP1, uniformBlockStorage, postShaders, useShadows);
+		baseOutputFramebuffer = &renderer.auxiliaryFramebuffer1;
+		drawBase(renderer, *baseOutputFramebuffer, cameraP1, uniformBlockStorage, postShaders, useShadows);
 	}
 
 
@@ -166,12 +117,12 @@ void RenderingSystem::drawScene(const Framebuffer& framebuffer, Camera& cameraP1
 
     
 
-    fxaaFilter(FXAAShader, *baseOutputFramebuffer, *baseOutputFramebuffer, framebuffer);
+    renderer.fxaaFilter(FXAAShader, *baseOutputFramebuffer, *baseOutputFramebuffer, framebuffer);
 
 }
 
-void RenderingSystem::drawHud(const Framebuffer& framebuffer) {
-    if (!initializedHud) initHud(); // Inicjalizacja, jeśli nie została wykonana
+void RenderingSystem::drawHud(Renderer& renderer, const Framebuffer& framebuffer) {
+    TextRenderer& textRenderer = renderer.getTextRenderer();
 
     auto [width, height] = framebuffer.GetSizePair();
     glm::mat4 ortho = glm::ortho(0.0f, (float)width, (float)height, 0.0f, -1.0f, 1.0f);
@@ -179,293 +130,192 @@ void RenderingSystem::drawHud(const Framebuffer& framebuffer) {
 
     glEnable(GL_BLEND);
     glDisable(GL_DEPTH_TEST);
-    auto transforms = scene->getStorage<Transform>();
-    auto images = scene->getStorage<ImageComponent>();
-    auto texts = scene->getStorage<TextComponent>();
-
-    if (images != NULL) {
-        for (int i = 0; i < images->getQuantity(); i++) {
-            auto& image = images->components[i];
-
-            EntityID entityID = image.id;
-            image.shader->use();
-
-            // TODO: uniform blocks
-            image.shader->setMat4("projection", ortho);
-
-            image.shader->setMat4("model", glm::scale(transforms->get(entityID).globalMatrix, glm::vec3(image.width, image.height, 1.0f)));
-            if (!image.texturePath.empty()) {
-                if (GLuint textureID = getTexture(image.texturePath)) {
-                    glActiveTexture(GL_TEXTURE0);
-                    glBindTexture(GL_TEXTURE_2D, textureID);
-                    image.shader->setInt("useTexture", true);
-                } else {
-                    image.shader->setInt("useTexture", false);
-                    image.shader->setVec4("color", image.color);
-                }
+    scene->view<ImageComponent, Transform>().each([&](EntityID, ImageComponent& image, Transform& transform) {
+        if (!transform.isActive) return;
+        image.shader->use();
+
+        // TODO: uniform blocks
+        image.shader->setMat4("projection", ortho);
+
+        image.shader->setMat4("model", glm::scale(transform.globalMatrix, glm::vec3(image.width, image.height, 1.0f)));
+        if (!image.texturePath.empty()) {
+            if (GLuint textureID = renderer.getTexture(image.texturePath)) {
+                glActiveTexture(GL_TEXTURE0);
+                glBindTexture(GL_TEXTURE_2D, textureID);
+                image.shader->setInt("useTexture", true);
             } else {
                 image.shader->setInt("useTexture", false);
                 image.shader->setVec4("color", image.color);
             }
-            glBindVertexArray(hudVAO);
-            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-            glBindVertexArray(0);
+        } else {
+            image.shader->setInt("useTexture", false);
+            image.shader->setVec4("color", image.color);
         }
-    }
-
-    if (texts != NULL) {
-        for (int i = 0; i < texts->getQuantity(); i++) {
-            auto& text = texts->components[i];
+        renderer.drawQuad();
+    });
 
-            EntityID entityID = text.id;
-
-            text.shader->use();
-            text.shader->setMat4("projection", ortho);
-            t1.renderText(text.shader, text.text, transforms->get(entityID).translation.x, transforms->get(entityID).translation.y, 1.0f, text.color);
-        }
-    }
+    scene->view<TextComponent, Transform>().each([&](EntityID, TextComponent& text, Transform& transform) {
+        if (!transform.isActive) return;
+        text.shader->use();
+        text.shader->setMat4("projection", ortho);
+        textRenderer.renderText(text.shader, text.text, transform.translation.x, transform.translation.y, 1.0f, text.color);
+    });
 
     glDisable(GL_BLEND);
     glEnable(GL_DEPTH_TEST);
 }
 
-GLuint RenderingSystem::getTexture(std::string path) {
-    if (textures.find(path) != textures.end()) {
-        return textures[path];
-    }
-
-    int width, height, nrChannels;
-    unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
-    if (data) {
-        GLuint textureID;
-        glGenTextures(1, &textureID);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        stbi_image_free(data);
-
-        textures[path] = textureID;
-        return textureID;
-    } else {
-        std::cerr << "Failed to load texture: " << path << std::endl;
-        return 0;
-    }
-}
-
-void RenderingSystem::initHud() {
-    if (initializedHud) return;
-
-    float vertices[] = {
-        -1.0f, -1.0f, 0.0f, 0.0f,
-         1.0f, -1.0f, 1.0f, 0.0f,
-         1.0f,  1.0f, 1.0f, 1.0f,
-        -1.0f,  1.0f, 0.0f, 1.0f
-    };
-
-    unsigned int indices[] = {
-        0, 1, 2,
-        0, 2, 3
-    };
-
-    glGenVertexArrays(1, &hudVAO);
-    glGenBuffers(1, &hudVBO);
-    glGenBuffers(1, &hudEBO);
-
-    glBindVertexArray(hudVAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hudEBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-
-    t1.init("../../res/fonts/sixtyfour.ttf");
-
-    initializedHud = true;
-}
-
 void RenderingSystem::buildTree() {
     auto models = scene->getStorage<ModelComponent>();
+    auto transforms = scene->getStorage<Transform>();
+    treeTick = scene->advanceChangeTick();
+    if (models == nullptr || transforms == nullptr) {
+        rootNode.reset();
+        treeStaticCount = 0;
+        return;
+    }
+
     std::vector<ModelComponent*> modelComponents;
     modelComponents.reserve(models->getQuantity());
 
     for (int i = 0; i < models->getQuantity(); i++) {
-        models->components[i].transform = &scene->getComponent<Transform>(models->components[i].id);
-        if (models->components[i].transform->isStatic)
+        // storage->get nie oznacza transformu jako zmienionego
+        models->components[i].transform = &transforms->get(models->components[i].id);
+        if (models->components[i].transform->isStatic && models->components[i].transform->isActive)
             modelComponents.push_back(&models->components[i]);
     }
 
+    treeStaticCount = modelComponents.size();
     rootNode = buildBVH(modelComponents);
 }
 
-void RenderingSystem::sobelFilter(Shader* sobel, const CustomFramebuffer &in, const Framebuffer &out) {
-    out.Bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    sobel->use();
-    auto [width, height] = in.GetSizePair();
-    sobel->setInt("width", width);
-    sobel->setInt("height", height);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
-    sobel->setInt("textureSampler", 0);
-
-    glBindVertexArray(hudVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
-
-void RenderingSystem::motionBlurFilter(Shader* blur, const CustomFramebuffer& in, 
-    const CustomFramebuffer& inVel, const Framebuffer& out) {
-    out.Bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    blur->use();
-    auto [width, height] = in.GetSizePair();
-    blur->setInt("width", width);
-    blur->setInt("height", height);
-
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, inVel.GetVelocityTexture());
-    blur->setInt("textureSampler", 0);
-    blur->setInt("velTextureSampler", 1);
-
-    glBindVertexArray(hudVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
-}
+// przebudowa BVH tylko gdy zmienił się zbiór obiektów statycznych albo któryś z nich
+void RenderingSystem::refreshTree() {
+    if (!useTree || !rootNode) return;
+
+    const Scene& constScene = *scene;
+    size_t staticCount = 0;
+    bool changed = false;
+    constScene.view<ModelComponent, Transform>().each([&](EntityID id, const ModelComponent&, const Transform& transform) {
+        if (!transform.isStatic || !transform.isActive) return;
+        staticCount++;
+        if (!changed) {
+            changed = constScene.changedSince<Transform>(id, treeTick) || constScene.changedSince<ModelComponent>(id, treeTick);
+        }
+    });
 
-void RenderingSystem::fxaaFilter(Shader* fxaa, const CustomFramebuffer& in, 
-    const CustomFramebuffer& test, const Framebuffer& out) {
-    out.Bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    fxaa->use();
-    auto [width, height] = in.GetSizePair();
-    fxaa->setVec2("resolution", (float)width, (float)height);
-    glActiveTexture(GL_TEXTURE0);
-    glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
-    fxaa->setInt("textureSampler", 0);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, test.GetColorTexture());
-	fxaa->setInt("testSampler", 1);
-
-    glBindVertexArray(hudVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+    if (changed || staticCount != treeStaticCount) {
+        buildTree();
+    }
 }
 
-void RenderingSystem::shadowFxaaFilter(Shader* fxaa, const CustomFramebuffer& in, const Framebuffer& out) {
-    out.Bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    fxaa->use();
-    auto [width, height] = in.GetSizePair();
-    fxaa->setVec2("resolution", (float)width, (float)height);
-    glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, in.GetDepthTexture());
-    fxaa->setInt("shadowMap", 0);
-
-    glBindVertexArray(hudVAO);
-    glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-    glBindVertexArray(0);
+void RenderingSystem::updatePreviousModelMatrices() {
+    uint32_t since = previousMatricesTick;
+    previousMatricesTick = scene->advanceChangeTick();
+
+    auto view = scene->view<ModelComponent, Transform>();
+    view.each([&](EntityID id, ModelComponent& modelComponent, Transform& transform) {
+        // niezmieniony transform ma już prevModelMatrix == globalMatrix z poprzedniej klatki
+        if (view.changedSince<Transform>(id, since) || view.changedSince<ModelComponent>(id, since)) {
+            modelComponent.prevModelMatrix = transform.globalMatrix;
+        }
+    });
 }
 
-void RenderingSystem::ssaoFilter(Shader* ssao, const CustomFramebuffer& gBuffer, const Framebuffer& out) {
-    out.Bind();
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	ssao->use();
-	auto [width, height] = gBuffer.GetSizePair();
-	ssao->setInt("width", width);
-	ssao->setInt("height", height);
+void RenderingSystem::updateCameras(float aspectRatio) {
+    uint32_t since = camerasTick;
+    camerasTick = scene->advanceChangeTick();
 
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, gBuffer.GetNormalTexture());
-	ssao->setInt("normalTexture", 1);
+    auto view = scene->view<CameraComponent, Transform>();
+    view.each([&](EntityID id, CameraComponent& cameraComponent, Transform& transform) {
+        if (view.changedSince<Transform>(id, since)) {
+            cameraComponent.camera.setInvViewMatrix(transform.globalMatrix);
+        }
+        if (view.changedSince<CameraComponent>(id, since) || cameraComponent.aspectRatio != aspectRatio) {
+            cameraComponent.aspectRatio = aspectRatio;
+            cameraComponent.updateProjectionMatrix();
+        }
+    });
+}
 
-	glActiveTexture(GL_TEXTURE2);
-	glBindTexture(GL_TEXTURE_2D, ssaoNoiseTexture);
-	ssao->setInt("noiseTexture", 2);
+static void uploadPointLight(const UniformBlock& lightBlock, int index, const PointLightComponent& light, const Transform& transform) {
+    std::string prefix = "pointLights[" + std::to_string(index) + "].";
+    glm::vec3 position = transform.globalMatrix[3];
+    lightBlock.setData(prefix + "position", &position);
+    lightBlock.setData(prefix + "color", &light.color);
+    lightBlock.setData(prefix + "intensity", &light.intensity);
+    lightBlock.setData(prefix + "constant", &light.constant);
+    lightBlock.setData(prefix + "linear", &light.linear);
+    lightBlock.setData(prefix + "quadratic", &light.quadratic);
+}
 
-	glActiveTexture(GL_TEXTURE3);
-	glBindTexture(GL_TEXTURE_2D, gBuffer.GetDepthTexture());
-	ssao->setInt("depthTexture", 3);
+static void uploadDirectionalLight(const UniformBlock& lightBlock, int index, const DirectionalLightComponent& light, const Transform& transform) {
+    std::string prefix = "directionalLights[" + std::to_string(index) + "].";
+    glm::vec3 direction = -transform.globalMatrix[2];
+    lightBlock.setData(prefix + "direction", &direction);
+    lightBlock.setData(prefix + "color", &light.color);
+    lightBlock.setData(prefix + "intensity", &light.intensity);
+}
 
+// Indeks światła w UBO = kolejność w widoku, więc po dodaniu/usunięciu światła wysyłamy wszystkie,
+// a w pozostałych klatkach tylko te, których komponent albo transform się zmienił.
+void RenderingSystem::uploadLights(const UniformBlockStorage& uniformBlockStorage) {
+    auto& lightBlock = uniformBlockStorage.lightBlock;
+    const Scene& constScene = *scene;
 
-	glBindVertexArray(hudVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-}
+    uint32_t since = lightsTick;
+    bool firstUpload = lightsTick == 0;
+    lightsTick = scene->advanceChangeTick();
 
-void RenderingSystem::ssaoApplyFilter(Shader* ssaoApply, const CustomFramebuffer& in, const CustomFramebuffer& ssao, const Framebuffer& out)
-{
-	out.Bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	ssaoApply->use();
-	auto [width, height] = in.GetSizePair();
-	ssaoApply->setInt("width", width);
-	ssaoApply->setInt("height", height);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
-	ssaoApply->setInt("colorTexture", 0);
-
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, ssao.GetColorTexture());
-	ssaoApply->setInt("ssaoTexture", 1);
-
-	glBindVertexArray(hudVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-}
+    if (firstUpload) {
+        glm::vec4 ambientColor = glm::vec4(0.3f, 0.3f, 0.3f, 1.0f); // Temporary ambient color
+        lightBlock.setData("ambientColor", &ambientColor);
+    }
 
-void RenderingSystem::dynamicSplitScreen(Shader *dynamicSplitScreen, Camera& camera, const CustomFramebuffer &in,
-	CustomFramebuffer &in2, const Framebuffer &out) {
-	out.Bind();
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	dynamicSplitScreen->use();
-
-	glm::vec2 viewportSize = glm::vec2(in.GetSizePair().first, in.GetSizePair().second);
-	dynamicSplitScreen->setVec2("viewport_size", viewportSize);
-
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
-	dynamicSplitScreen->setInt("viewport1", 0);
-	glActiveTexture(GL_TEXTURE1);
-	glBindTexture(GL_TEXTURE_2D, in2.GetColorTexture());
-	dynamicSplitScreen->setInt("viewport2", 1);
-	glBindVertexArray(hudVAO);
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-	glBindVertexArray(0);
-}
+    // point lights
+    auto pointLights = constScene.getStorage<PointLightComponent>();
+    uint32_t pointStructure = pointLights ? pointLights->getStructureVersion() : 0;
+    bool pointFull = firstUpload || pointStructure != pointLightsStructure;
+    pointLightsStructure = pointStructure;
+
+    int pointLightCount = 0;
+    auto pointView = constScene.view<PointLightComponent, Transform>();
+    pointView.each([&](EntityID id, const PointLightComponent& light, const Transform& transform) {
+        int index = pointLightCount++;
+        if (pointFull || pointView.changedSince<PointLightComponent>(id, since) || pointView.changedSince<Transform>(id, since)) {
+            uploadPointLight(lightBlock, index, light, transform);
+        }
+    });
+    if (pointFull) {
+        lightBlock.setData("pointLightCount", &pointLightCount);
+    }
 
-void RenderingSystem::updatePreviousModelMatrices() {
-    auto models = scene->getStorage<ModelComponent>();
-    for (int i = 0; i < models->getQuantity(); i++) {
-        auto& modelComponent = models->components[i];
-		auto& transform = scene->getComponent<Transform>(modelComponent.id);
-        modelComponent.prevModelMatrix = transform.globalMatrix;
+    // directional lights
+    auto directionalLights = constScene.getStorage<DirectionalLightComponent>();
+    uint32_t directionalStructure = directionalLights ? directionalLights->getStructureVersion() : 0;
+    bool directionalFull = firstUpload || directionalStructure != directionalLightsStructure;
+    directionalLightsStructure = directionalStructure;
+
+    int directionalLightCount = 0;
+    auto directionalView = constScene.view<DirectionalLightComponent, Transform>();
+    directionalView.each([&](EntityID id, const DirectionalLightComponent& light, const Transform& transform) {
+        int index = directionalLightCount++;
+        if (directionalFull || directionalView.changedSince<DirectionalLightComponent>(id, since) || directionalView.changedSince<Transform>(id, since)) {
+            uploadDirectionalLight(lightBlock, index, light, transform);
+        }
+    });
+    if (directionalFull) {
+        lightBlock.setData("directionalLightCount", &directionalLightCount);
     }
 }
 
-void RenderingSystem::drawBase(const CustomFramebuffer& outputFramebuffer, Camera& camera, const UniformBlockStorage& uniformBlockStorage, 
+void RenderingSystem::drawBase(Renderer& renderer, const CustomFramebuffer& outputFramebuffer, Camera& camera, const UniformBlockStorage& uniformBlockStorage, 
     const std::unordered_map<std::string, Shader*>& postShaders, bool useShadows) {
 	auto& frustum = camera.getFrustum();
     auto models = scene->getStorage<ModelComponent>();
     auto transforms = scene->getStorage<Transform>();
-    uint16_t renderingQueueSize = 0;
-
-    EntityID renderingQueue[MAX_ENTITIES];
+    std::vector<EntityID> renderingQueue;
+    renderingQueue.reserve(models->getQuantity());
 
     FrustumPlanes globalPlanes = frustum.getPlanes();
     globalPlanes.applyTransform(camera.getInvViewMatrix());
@@ -486,24 +336,23 @@ void RenderingSystem::drawBase(const CustomFramebuffer& outputFramebuffer, Camer
 
     Shader* shadowShader = postShaders.at("ShadowMap");
 
-    for (int i = 0; i < models->getQuantity(); i++) {
-        auto& modelComponent = models->components[i];
-
-        if (!useTree || !transforms->get(models->components[i].id).isStatic)
+    scene->view<ModelComponent, Transform>().each([&](EntityID id, ModelComponent& modelComponent, Transform& transform) {
+        if (!transform.isActive) return;
+        if (!useTree || !transform.isStatic)
         {
             auto& boundingBox = modelComponent.model->boundingBox;
 
 
-            if (isOnFrustum(boundingBox, globalPlanes, transforms->get(modelComponent.id))) {
-                renderingQueue[renderingQueueSize++] = modelComponent.id;
+            if (isOnFrustum(boundingBox, globalPlanes, transform)) {
+                renderingQueue.push_back(id);
             }
         }
-    }
+    });
 
     for(int i = 0; i < visibleEntities.size(); i++) {
         EntityID entityID = visibleEntities[i];
         if (models->has(entityID)) {
-            renderingQueue[renderingQueueSize++] = entityID;
+            renderingQueue.push_back(entityID);
         }
     }
 
@@ -525,6 +374,7 @@ void RenderingSystem::drawBase(const CustomFramebuffer& outputFramebuffer, Camer
     cameraBlock.setData("invViewProjection", &invViewProjectionMatrix);
 
 
+    CustomFramebuffer& customFramebuffer = renderer.customFramebuffer;
     customFramebuffer.Bind();
     GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
     glDrawBuffers(4, drawBuffers);
@@ -542,14 +392,13 @@ void RenderingSystem::drawBase(const CustomFramebuffer& outputFramebuffer, Camer
     if (useShadows)
     {
         glActiveTexture(GL_TEXTURE0 + 1);
-        glBindTexture(GL_TEXTURE_2D, shadowPostFramebuffer.GetColorTexture());
+        glBindTexture(GL_TEXTURE_2D, renderer.shadowPostFramebuffer.GetColorTexture());
     }
 
-    for (int i = 0; i < renderingQueueSize; i++) {
+    for (int i = 0; i < renderingQueue.size(); i++) {
         auto& modelComponent = models->get(renderingQueue[i]);
 
         EntityID entityID = modelComponent.id;
-		auto& info = scene->getComponent<ObjectInfoComponent>(entityID);
 
 		glm::mat4 modelMatrix = transforms->get(entityID).globalMatrix;
         modelComponent.shader->use();
@@ -576,15 +425,15 @@ void RenderingSystem::drawBase(const CustomFramebuffer& outputFramebuffer, Camer
     Shader* ssaoShader = postShaders.at("SSAO");
     Shader* ssaoApplyShader = postShaders.at("SSAOApply");
 
-    ssaoFilter(ssaoShader, customFramebuffer, ssaoFramebuffer);
-    sobelFilter(sobelShader, customFramebuffer, postProcessingFramebuffer1);
-    ssaoApplyFilter(ssaoApplyShader, postProcessingFramebuffer1, ssaoFramebuffer, 
+    renderer.ssaoFilter(ssaoShader, customFramebuffer, renderer.ssaoFramebuffer);
+    renderer.sobelFilter(sobelShader, customFramebuffer, renderer.postProcessingFramebuffer1);
+    renderer.ssaoApplyFilter(ssaoApplyShader, renderer.postProcessingFramebuffer1, renderer.ssaoFramebuffer, 
 		outputFramebuffer);
 
 
     /*if (showMotionBlur)
     {
         cameraBlock.setData("prevViewProjection", &viewProjectionMatrix);
-        motionBlurFilter(motionBlurShader, postProcessingFramebuffer2, customFramebuffer, outputFramebuffer);
+        renderer.motionBlurFilter(motionBlurShader, renderer.postProcessingFramebuffer2, customFramebuffer, outputFramebuffer);
     }*/
 }
\ No newline at end of file
@@ -0,0 +1,151 @@
+#include "SystemScheduler.h"
+
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <thread>
+
+
+static bool intersects(const std::vector<ComponentTypeID>& first, const std::vector<ComponentTypeID>& second)
+{
+    for (ComponentTypeID type : first)
+    {
+        if (std::find(second.begin(), second.end(), type) != second.end())
+            return true;
+    }
+    return false;
+}
+
+void SystemScheduler::addSystem(SystemDesc system)
+{
+    nodes.push_back({ std::move(system) });
+    timings.push_back({ nodes.back().system.name });
+    graphDirty = true;
+}
+
+bool SystemScheduler::conflicts(const SystemDesc& first, const SystemDesc& second) const
+{
+    if (first.exclusive || second.exclusive)
+        return true;
+
+    return intersects(first.access.writes, second.access.writes) ||
+        intersects(first.access.writes, second.access.reads) ||
+        intersects(first.access.reads, second.access.writes);
+}
+
+void SystemScheduler::buildGraph()
+{
+    for (auto& node : nodes)
+    {
+        node.dependents.clear();
+        node.dependencyCount = 0;
+    }
+
+    for (uint32_t later = 0; later < nodes.size(); later++)
+    {
+        for (uint32_t earlier = 0; earlier < later; earlier++)
+        {
+            if (conflicts(nodes[earlier].system, nodes[later].system))
+            {
+                nodes[earlier].dependents.push_back(later);
+                nodes[later].dependencyCount++;
+            }
+        }
+    }
+    prepares.clear();
+    for (const auto& node : nodes)
+    {
+        for (auto prepare : node.system.access.prepare)
+        {
+            if (std::find(prepares.begin(), prepares.end(), prepare) == prepares.end())
+                prepares.push_back(prepare);
+        }
+    }
+
+    remaining = std::make_unique<std::atomic<uint32_t>[]>(nodes.size());
+    // wszystkie systemy naraz w kolejce wątku głównego - push_back w run() nie alokuje
+    mainThreadReady.clear();
+    mainThreadReady.reserve(nodes.size());
+    graphDirty = false;
+}
+
+void SystemScheduler::execute(uint32_t index)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    nodes[index].system.update();
+    auto end = std::chrono::high_resolution_clock::now();
+    timings[index].startMilliseconds = std::chrono::duration<float, std::milli>(start - runStart).count();
+    timings[index].milliseconds = std::chrono::duration<float, std::milli>(end - start).count();
+
+    for (uint32_t dependent : nodes[index].dependents)
+    {
+        if (remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1)
+            schedule(dependent);
+    }
+    completed.fetch_add(1, std::memory_order_acq_rel);
+}
+
+void SystemScheduler::schedule(uint32_t index)
+{
+    if (nodes[index].system.mainThread)
+    {
+        std::lock_guard lock(mainThreadMutex);
+        mainThreadReady.push_back(index);
+    }
+    else
+    {
+        // this + indeks mieszczą się w buforze std::function - bez alokacji
+        JobSystem::GetInstance().run([this, index]() { execute(index); }, counter);
+    }
+}
+
+void SystemScheduler::run(Scene& scene)
+{
+    if (nodes.empty())
+        return;
+
+    if (graphDirty)
+        buildGraph();
+
+    // storage tworzone/odłączane tylko tutaj - w trakcie systemów Scene::storages się nie zmienia
+    for (auto prepare : prepares)
+    {
+        prepare(scene);
+    }
+
+    auto& jobSystem = JobSystem::GetInstance();
+
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        remaining[i].store(nodes[i].dependencyCount, std::memory_order_relaxed);
+    }
+    completed.store(0, std::memory_order_relaxed);
+    runStart = std::chrono::high_resolution_clock::now();
+
+    for (uint32_t i = 0; i < nodes.size(); i++)
+    {
+        if (nodes[i].dependencyCount == 0)
+            schedule(i);
+    }
+
+    while (completed.load(std::memory_order_acquire) < nodes.size())
+    {
+        uint32_t index = (uint32_t)-1;
+        {
+            std::lock_guard lock(mainThreadMutex);
+            // najpierw wcześniej zarejestrowane - ta sama kolejność co przy wykonaniu sekwencyjnym
+            auto it = std::min_element(mainThreadReady.begin(), mainThreadReady.end());
+            if (it != mainThreadReady.end())
+            {
+                index = *it;
+                mainThreadReady.erase(it);
+            }
+        }
+
+        if (index != (uint32_t)-1)
+            execute(index);
+        else if (!jobSystem.tryRunOne())
+            std::this_thread::yield();
+    }
+    jobSystem.wait(counter);
+}
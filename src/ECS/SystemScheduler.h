@@ -0,0 +1,101 @@
+#ifndef PBL_SYSTEMSCHEDULER_H
+#define PBL_SYSTEMSCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ComponentStorage.h"
+#include "JobSystem.h"
+#include "Scene.h"
+
+// Deklaracja dostępu systemu do komponentów, np. SystemAccess().read<Transform>().write<VelocityComponent>()
+struct SystemAccess {
+    std::vector<ComponentTypeID> reads;
+    std::vector<ComponentTypeID> writes;
+    // przygotowanie storage przed równoległym wykonaniem (patrz Scene::prepareStorage)
+    std::vector<void(*)(Scene&)> prepare;
+
+    template<typename... Ts>
+    SystemAccess& read() {
+        (add<Ts>(reads), ...);
+        return *this;
+    }
+
+    template<typename... Ts>
+    SystemAccess& write() {
+        (add<Ts>(writes), ...);
+        return *this;
+    }
+
+private:
+    template<typename T>
+    void add(std::vector<ComponentTypeID>& types) {
+        types.push_back(componentTypeId<T>());
+        prepare.push_back([](Scene& scene) { scene.prepareStorage<T>(); });
+    }
+};
+
+struct SystemDesc {
+    std::string name;
+    SystemAccess access;
+    std::function<void()> update;
+    // wejście GLFW i inne API dostępne tylko z wątku głównego
+    bool mainThread = false;
+    // dotyka zasobów spoza zadeklarowanych komponentów (command buffer, zdarzenia, cały graf transformacji) -
+    // wykonywany sam, po wszystkich wcześniejszych i przed wszystkimi późniejszymi systemami
+    bool exclusive = false;
+};
+
+struct SystemTiming {
+    std::string name;
+    // początek względem startu run() - nakładające się przedziały to systemy wykonane równolegle
+    float startMilliseconds = 0.0f;
+    float milliseconds = 0.0f;
+};
+
+// Wykonuje systemy w kolejności rejestracji z zachowaniem zależności: system czeka na wcześniejsze,
+// z którymi ma konflikt (zapis-odczyt lub zapis-zapis tego samego typu). Systemy bez konfliktu
+// idą równolegle przez JobSystem. Graf zależności i stan wykonania są budowane przy pierwszym run()
+// po rejestracji - kolejne klatki nic nie alokują.
+class SystemScheduler {
+public:
+    void addSystem(SystemDesc system);
+
+    void run(Scene& scene);
+
+    // czasy z ostatniego run(), w kolejności rejestracji
+    const std::vector<SystemTiming>& getTimings() const { return timings; }
+
+private:
+    struct Node {
+        SystemDesc system;
+        std::vector<uint32_t> dependents;
+        uint32_t dependencyCount = 0;
+    };
+
+    void buildGraph();
+    bool conflicts(const SystemDesc& first, const SystemDesc& second) const;
+    void schedule(uint32_t index);
+    void execute(uint32_t index);
+
+    std::vector<Node> nodes;
+    std::vector<SystemTiming> timings;
+    // przygotowanie storage ze wszystkich systemów, bez powtórzeń
+    std::vector<void(*)(Scene&)> prepares;
+    bool graphDirty = false;
+
+    // stan jednego run(), rozmiar ustalany w buildGraph
+    std::unique_ptr<std::atomic<uint32_t>[]> remaining;
+    std::atomic<uint32_t> completed{ 0 };
+    std::mutex mainThreadMutex;
+    std::vector<uint32_t> mainThreadReady;
+    JobCounter counter;
+    std::chrono::high_resolution_clock::time_point runStart;
+};
+
+#endif //PBL_SYSTEMSCHEDULER_H
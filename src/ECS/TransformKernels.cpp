@@ -0,0 +1,144 @@
+#include "TransformKernels.h"
+
+#ifdef PBL_TRANSFORM_SSE
+#include <emmintrin.h>
+#endif
+
+namespace TransformKernels {
+
+    static glm::mat4 composeLocal(const Transform& transform)
+    {
+        const glm::quat& q = transform.rotation;
+        const glm::vec3& s = transform.scale;
+
+        float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+        float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+        float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+        // to samo co glm::mat3_cast, kolumny przeskalowane
+        glm::mat4 result;
+        result[0] = glm::vec4(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy), 0.0f) * s.x;
+        result[1] = glm::vec4(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx), 0.0f) * s.y;
+        result[2] = glm::vec4(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy), 0.0f) * s.z;
+        result[3] = glm::vec4(transform.translation, 1.0f);
+        return result;
+    }
+
+    void composeLocalMatricesScalar(const Transform* transforms, std::span<const uint32_t> indices, glm::mat4* out)
+    {
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            out[i] = composeLocal(transforms[indices[i]]);
+        }
+    }
+
+    glm::mat4 multiplyAffineScalar(const glm::mat4& parent, const glm::mat4& local)
+    {
+        glm::mat4 result;
+        for (int column = 0; column < 3; column++)
+        {
+            result[column] = parent[0] * local[column].x + parent[1] * local[column].y + parent[2] * local[column].z;
+        }
+        result[3] = parent[0] * local[3].x + parent[1] * local[3].y + parent[2] * local[3].z + parent[3];
+        return result;
+    }
+
+#ifdef PBL_TRANSFORM_SSE
+
+    // zapis kolumny: cztery wektory SoA (wiersze 0-3 dla 4 macierzy) -> ta kolumna w każdej z 4 macierzy
+    static void storeColumn(__m128 row0, __m128 row1, __m128 row2, __m128 row3, glm::mat4* out, int column)
+    {
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+        _mm_storeu_ps(&out[0][column].x, row0);
+        _mm_storeu_ps(&out[1][column].x, row1);
+        _mm_storeu_ps(&out[2][column].x, row2);
+        _mm_storeu_ps(&out[3][column].x, row3);
+    }
+
+    void composeLocalMatrices(const Transform* transforms, std::span<const uint32_t> indices, glm::mat4* out)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        const __m128 zero = _mm_setzero_ps();
+
+        size_t i = 0;
+        for (; i + 4 <= indices.size(); i += 4)
+        {
+            const Transform& a = transforms[indices[i]];
+            const Transform& b = transforms[indices[i + 1]];
+            const Transform& c = transforms[indices[i + 2]];
+            const Transform& d = transforms[indices[i + 3]];
+
+            // transformy nie leżą obok siebie - zbieranie do układu SoA
+            __m128 qx = _mm_setr_ps(a.rotation.x, b.rotation.x, c.rotation.x, d.rotation.x);
+            __m128 qy = _mm_setr_ps(a.rotation.y, b.rotation.y, c.rotation.y, d.rotation.y);
+            __m128 qz = _mm_setr_ps(a.rotation.z, b.rotation.z, c.rotation.z, d.rotation.z);
+            __m128 qw = _mm_setr_ps(a.rotation.w, b.rotation.w, c.rotation.w, d.rotation.w);
+            __m128 sx = _mm_setr_ps(a.scale.x, b.scale.x, c.scale.x, d.scale.x);
+            __m128 sy = _mm_setr_ps(a.scale.y, b.scale.y, c.scale.y, d.scale.y);
+            __m128 sz = _mm_setr_ps(a.scale.z, b.scale.z, c.scale.z, d.scale.z);
+            __m128 tx = _mm_setr_ps(a.translation.x, b.translation.x, c.translation.x, d.translation.x);
+            __m128 ty = _mm_setr_ps(a.translation.y, b.translation.y, c.translation.y, d.translation.y);
+            __m128 tz = _mm_setr_ps(a.translation.z, b.translation.z, c.translation.z, d.translation.z);
+
+            __m128 xx = _mm_mul_ps(qx, qx), yy = _mm_mul_ps(qy, qy), zz = _mm_mul_ps(qz, qz);
+            __m128 xy = _mm_mul_ps(qx, qy), xz = _mm_mul_ps(qx, qz), yz = _mm_mul_ps(qy, qz);
+            __m128 wx = _mm_mul_ps(qw, qx), wy = _mm_mul_ps(qw, qy), wz = _mm_mul_ps(qw, qz);
+
+            __m128 m00 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            __m128 m01 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx);
+            __m128 m02 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx);
+
+            __m128 m10 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy);
+            __m128 m11 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            __m128 m12 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy);
+
+            __m128 m20 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz);
+            __m128 m21 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz);
+            __m128 m22 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+
+            storeColumn(m00, m01, m02, zero, out + i, 0);
+            storeColumn(m10, m11, m12, zero, out + i, 1);
+            storeColumn(m20, m21, m22, zero, out + i, 2);
+            storeColumn(tx, ty, tz, one, out + i, 3);
+        }
+
+        composeLocalMatricesScalar(transforms, indices.subspan(i), out + i);
+    }
+
+    glm::mat4 multiplyAffine(const glm::mat4& parent, const glm::mat4& local)
+    {
+        __m128 p0 = _mm_loadu_ps(&parent[0].x);
+        __m128 p1 = _mm_loadu_ps(&parent[1].x);
+        __m128 p2 = _mm_loadu_ps(&parent[2].x);
+        __m128 p3 = _mm_loadu_ps(&parent[3].x);
+
+        glm::mat4 result;
+        for (int column = 0; column < 4; column++)
+        {
+            __m128 value = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(p0, _mm_set1_ps(local[column].x)), _mm_mul_ps(p1, _mm_set1_ps(local[column].y))),
+                _mm_mul_ps(p2, _mm_set1_ps(local[column].z)));
+            // w kolumnach 0-2 lokalnej macierzy jest 0, w kolumnie przesunięcia 1
+            if (column == 3)
+                value = _mm_add_ps(value, p3);
+            _mm_storeu_ps(&result[column].x, value);
+        }
+        return result;
+    }
+
+#else
+
+    void composeLocalMatrices(const Transform* transforms, std::span<const uint32_t> indices, glm::mat4* out)
+    {
+        composeLocalMatricesScalar(transforms, indices, out);
+    }
+
+    glm::mat4 multiplyAffine(const glm::mat4& parent, const glm::mat4& local)
+    {
+        return multiplyAffineScalar(parent, local);
+    }
+
+#endif
+
+}
@@ -0,0 +1,27 @@
+#ifndef PBL_TRANSFORMKERNELS_H
+#define PBL_TRANSFORMKERNELS_H
+
+#include <span>
+
+#include "Components.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PBL_TRANSFORM_SSE 1
+#endif
+
+// Składanie macierzy transformów bez ogólnych mnożeń 4x4 (glm::translate, mat4_cast, glm::scale):
+// macierz lokalna liczona wprost z kwaternionu, skali i przesunięcia, a z rodzicem jedno mnożenie afiniczne.
+// Wersja SSE liczy 4 macierze lokalne naraz, skalarna jest używana dla reszty i bez SSE.
+namespace TransformKernels {
+
+    // out[i] = T * R * S dla transforms[indices[i]]
+    void composeLocalMatrices(const Transform* transforms, std::span<const uint32_t> indices, glm::mat4* out);
+    void composeLocalMatricesScalar(const Transform* transforms, std::span<const uint32_t> indices, glm::mat4* out);
+
+    // parent * local, obie macierze afiniczne (ostatni wiersz 0, 0, 0, 1)
+    glm::mat4 multiplyAffine(const glm::mat4& parent, const glm::mat4& local);
+    glm::mat4 multiplyAffineScalar(const glm::mat4& parent, const glm::mat4& local);
+
+}
+
+#endif //PBL_TRANSFORMKERNELS_H
@@ -3,6 +3,11 @@
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/euler_angles.hpp>
 #include "Scene.h"
+#include "TransformKernels.h"
+#include "JobSystem.h"
+
+#include <cstdlib>
+#include <spdlog/spdlog.h>
 
 static void continuousQuatToEuler(glm::vec3& eulerAngles, const glm::quat& quat)
 {
@@ -45,35 +50,433 @@ static void continuousQuatToEuler(glm::vec3& eulerAngles, const glm::quat& quat)
 
 TransformSystem::TransformSystem(Scene* scene) : scene(scene) {}
 
-void TransformSystem::updateNode(EntityID id) const {
-    auto& transform = scene->getComponent<Transform>(id);
+uint32_t& TransformSystem::positionOf(EntityID id) const {
+    uint32_t index = entityIndex(id);
+    if (index >= hierarchyPosition.size()) {
+        hierarchyPosition.resize(index + 1, NO_POSITION);
+    }
+    return hierarchyPosition[index];
+}
 
-    if (transform.isDirty) {
-        if (transform.parent != (EntityID)-1) {
-            auto& parentTransform = scene->getComponent<Transform>(transform.parent);
-            transform.globalMatrix = parentTransform.globalMatrix;
+uint32_t TransformSystem::findPosition(EntityID id) const {
+    uint32_t index = entityIndex(id);
+    if (index >= hierarchyPosition.size())
+        return NO_POSITION;
+    uint32_t position = hierarchyPosition[index];
+    // porównanie pełnego ID - pozycja mogła zostać po usuniętej encji o tym samym indeksie
+    if (position >= hierarchy.size() || hierarchy[position].id != id)
+        return NO_POSITION;
+    return position;
+}
+
+void TransformSystem::appendSubtree(const ComponentStorage<Transform>& transforms,
+    const ComponentStorage<TransformInfoComponent>& infos, EntityID id, uint32_t parent) const {
+    // pre-order bez rekurencji - hierarchie mogą być bardzo głębokie
+    std::vector<std::pair<EntityID, uint32_t>> stack;
+    stack.emplace_back(id, parent);
+    while (!stack.empty()) {
+        auto [node, nodeParent] = stack.back();
+        stack.pop_back();
+
+        uint32_t position = static_cast<uint32_t>(hierarchy.size());
+        positionOf(node) = position;
+        hierarchy.push_back({ node, nodeParent, static_cast<uint32_t>(transforms.indexOf(node)) });
+
+        if (!infos.has(node))
+            continue;
+        const auto& children = infos.get(node).children;
+        for (auto it = children.rbegin(); it != children.rend(); ++it) {
+            if (transforms.has(*it))
+                stack.emplace_back(*it, position);
         }
-        else
-        {
-			transform.globalMatrix = glm::mat4(1.0f);
+    }
+}
+
+void TransformSystem::rebuildHierarchy(const ComponentStorage<Transform>& transforms,
+    const ComponentStorage<TransformInfoComponent>& infos) const {
+    hierarchy.clear();
+    hierarchy.reserve(transforms.components.size());
+    std::fill(hierarchyPosition.begin(), hierarchyPosition.end(), NO_POSITION);
+    removedNodes = 0;
+
+    appendSubtree(transforms, infos, scene->getSceneRootEntity(), NO_PARENT);
+
+    // transformy nieosiągalne z korzenia - w buforze, żeby addChild mógł je później podpiąć
+    for (const auto& transform : transforms.components) {
+        if (findPosition(transform.id) != NO_POSITION)
+            continue;
+        if (transform.parent == (EntityID)-1 || !transforms.has(transform.parent))
+            appendSubtree(transforms, infos, transform.id, DETACHED);
+    }
+    // niespójne listy dzieci (np. cykl) - pojedynczo, też poza grafem
+    for (const auto& transform : transforms.components) {
+        if (findPosition(transform.id) == NO_POSITION)
+            appendSubtree(transforms, infos, transform.id, DETACHED);
+    }
+
+    transformStructureVersion = transforms.getStructureVersion();
+    hierarchyValid = true;
+}
+
+bool TransformSystem::refreshTransformIndices(const ComponentStorage<Transform>& transforms) const {
+    size_t liveNodes = 0;
+    for (auto& node : hierarchy) {
+        if (node.id == (EntityID)-1)
+            continue;
+
+        int32_t index = transforms.indexOf(node.id);
+        if (index < 0) {
+            // encja usunięta - jej dzieci też (Scene::destroyEntities usuwa całe poddrzewo)
+            node.id = (EntityID)-1;
+            removedNodes++;
+            continue;
         }
-        transform.globalMatrix = glm::translate(transform.globalMatrix, transform.translation);
-        transform.globalMatrix *= glm::mat4_cast(transform.rotation);
-        transform.globalMatrix = glm::scale(transform.globalMatrix, transform.scale);
+        node.transform = static_cast<uint32_t>(index);
+        liveNodes++;
+    }
+    transformStructureVersion = transforms.getStructureVersion();
 
-        transform.isDirty = false;
+    // transform dodany z pominięciem onEntityCreated - tylko pełna przebudowa
+    return liveNodes == transforms.components.size();
+}
+
+void TransformSystem::compactHierarchy() const {
+    // rodzic przed dzieckiem, więc nowa pozycja rodzica jest znana, zanim dojdziemy do dziecka
+    std::vector<uint32_t> remap(hierarchy.size(), NO_POSITION);
+    uint32_t write = 0;
+    for (uint32_t read = 0; read < hierarchy.size(); read++) {
+        HierarchyNode node = hierarchy[read];
+        if (node.id == (EntityID)-1)
+            continue;
+
+        if (node.parent != NO_PARENT && node.parent != DETACHED) {
+            node.parent = remap[node.parent] != NO_POSITION ? remap[node.parent] : DETACHED;
+        }
+        remap[read] = write;
+        hierarchy[write] = node;
+        hierarchyPosition[entityIndex(node.id)] = write;
+        write++;
     }
+    hierarchy.resize(write);
+    removedNodes = 0;
 }
 
-void TransformSystem::updateNodeRecursive(EntityID id) const {
-    updateNode(id);
-    for (auto child : scene->getComponent<Transform>(id).children) {
-        updateNodeRecursive(child);
+void TransformSystem::onEntityCreated(EntityID id) const {
+    if (!hierarchyValid)
+        return;
+
+    const Scene& constScene = *scene;
+    auto transforms = constScene.getStorage<Transform>();
+    uint32_t parent = findPosition(transforms->get(id).parent);
+    if (parent == NO_POSITION) {
+        hierarchyValid = false;
+        return;
+    }
+
+    // nowy liść na końcu - rodzic już jest wcześniej
+    positionOf(id) = static_cast<uint32_t>(hierarchy.size());
+    hierarchy.push_back({ id, parent, static_cast<uint32_t>(transforms->indexOf(id)) });
+
+    // add tylko dopisuje na koniec components - pozostałe indeksy są nadal aktualne
+    if (transformStructureVersion + 1 == transforms->getStructureVersion())
+        transformStructureVersion++;
+
+    markDirty(id);
+}
+
+void TransformSystem::invalidateHierarchy() const {
+    hierarchyValid = false;
+}
+
+TransformWriteQueue& TransformSystem::getWriteQueue(uint32_t index) const {
+    // również w wydaniu - indeks spoza tablicy pisałby po pamięci innych pól
+    if (index >= MAX_WRITE_QUEUES) {
+        spdlog::critical("TransformSystem: write queue index {} out of range ({} queues)", index, MAX_WRITE_QUEUES);
+        std::abort();
+    }
+    return writeQueues[index];
+}
+
+void TransformSystem::applyWriteQueues() const {
+    bool pending = false;
+    for (const auto& queue : writeQueues) {
+        pending |= !queue.empty();
+    }
+    if (!pending)
+        return;
+
+    using WriteType = TransformWriteQueue::WriteType;
+    auto transforms = scene->getStorage<Transform>();
+    auto infos = scene->getStorage<TransformInfoComponent>();
+    uint32_t tick = scene->getChangeTick();
+    for (auto& queue : writeQueues) {
+        for (const auto& write : queue.writes) {
+            // encja zniszczona po dodaniu zapisu (np. przy playback bufora komend)
+            if (!transforms->has(write.id))
+                continue;
+            if (write.type == WriteType::GlobalMatrix) {
+                setGlobalMatrix(write.id, queue.matrices[write.matrix]);
+                continue;
+            }
+
+            Transform& transform = transforms->getForWrite(write.id, tick);
+            switch (write.type) {
+            case WriteType::Translation:
+                transform.translation = write.vector;
+                break;
+            case WriteType::Rotation:
+                transform.rotation = write.rotation;
+                continuousQuatToEuler(infos->getForWrite(write.id, tick).eulerRotation, write.rotation);
+                break;
+            case WriteType::EulerRotation:
+                infos->getForWrite(write.id, tick).eulerRotation = write.vector;
+                transform.rotation = glm::quat(glm::radians(write.vector));
+                break;
+            case WriteType::EulerSlerp:
+                transform.rotation = glm::slerp(transform.rotation, glm::quat(glm::radians(write.vector)), write.delta);
+                continuousQuatToEuler(infos->getForWrite(write.id, tick).eulerRotation, transform.rotation);
+                break;
+            case WriteType::Scale:
+                transform.scale = write.vector;
+                break;
+            default:
+                break;
+            }
+            markDirty(write.id, transform);
+        }
+        queue.writes.clear();
+        queue.matrices.clear();
     }
 }
 
 void TransformSystem::update() const {
-    updateNodeRecursive(scene->getSceneRootEntity());
+    applyWriteQueues();
+
+    // storage pobierane raz na przebieg; dzieci czytane przez const - nie oznaczamy info jako zmienionych
+    auto transforms = scene->getStorage<Transform>();
+    auto infos = std::as_const(*scene).getStorage<TransformInfoComponent>();
+
+    if (!hierarchyValid ||
+        (transformStructureVersion != transforms->getStructureVersion() && !refreshTransformIndices(*transforms))) {
+        rebuildHierarchy(*transforms, *infos);
+        fullUpdate = true;
+    }
+    if (removedNodes > hierarchy.size() / 4) {
+        compactHierarchy();
+    }
+
+    uint32_t tick = scene->getChangeTick();
+    if (fullUpdate) {
+        updateAll(*transforms, tick);
+    }
+    else {
+        updateDirtyRoots(*transforms, *infos, tick);
+    }
+}
+
+void TransformSystem::updateAll(ComponentStorage<Transform>& transforms, uint32_t tick) const {
+    Transform* data = transforms.components.data();
+    // 0 - pominięty, 1 - osiągnięty, 2 - osiągnięty i przeliczony (dzieci też trzeba przeliczyć)
+    reached.resize(hierarchy.size());
+    updateLevel.resize(hierarchy.size());
+    updatePositions.clear();
+
+    for (uint32_t i = 0; i < hierarchy.size(); i++) {
+        HierarchyNode& node = hierarchy[i];
+        node.queued = false;
+        reached[i] = 0;
+        if (node.id == (EntityID)-1 || node.parent == DETACHED)
+            continue;
+        if (node.parent != NO_PARENT && !reached[node.parent])
+            continue;
+
+        Transform& transform = data[node.transform];
+        // nieaktywny transform pomijany razem z poddrzewem
+        if (!transform.isActive)
+            continue;
+        reached[i] = 1;
+
+        bool parentUpdated = node.parent != NO_PARENT && reached[node.parent] == 2;
+        if (transform.isDirty || parentUpdated) {
+            updateLevel[i] = parentUpdated ? updateLevel[node.parent] + 1 : 0;
+            updatePositions.push_back(i);
+            reached[i] = 2;
+        }
+    }
+    recompute(transforms, tick);
+
+    dirtyRoots.clear();
+    fullUpdate = false;
+}
+
+void TransformSystem::updateDirtyRoots(ComponentStorage<Transform>& transforms,
+    const ComponentStorage<TransformInfoComponent>& infos, uint32_t tick) const {
+    if (dirtyRoots.empty())
+        return;
+
+    Transform* data = transforms.components.data();
+
+    // oznaczenie wszystkich korzeni - flagi z markDirty mogły przepaść przy przenoszeniu poddrzewa
+    dirtyPositions.clear();
+    for (EntityID id : dirtyRoots) {
+        uint32_t position = findPosition(id);
+        if (position != NO_POSITION)
+            hierarchy[position].queued = false;
+    }
+    for (EntityID id : dirtyRoots) {
+        // encja usunięta po oznaczeniu albo duplikat
+        uint32_t position = findPosition(id);
+        if (position == NO_POSITION || hierarchy[position].queued)
+            continue;
+        hierarchy[position].queued = true;
+        dirtyPositions.push_back(position);
+    }
+    dirtyRoots.clear();
+
+    // Scalanie: korzeń z oznaczonym przodkiem jest pomijany - przodek przeliczy całe poddrzewo.
+    // Poddrzewo nieaktywne albo odpięte też pomijane - isDirty zostaje do ponownego oznaczenia.
+    // subtreeStack użyty tymczasowo na wynik - flagi queued są potrzebne do końca scalania
+    subtreeStack.clear();
+    for (uint32_t position : dirtyPositions) {
+        bool covered = false;
+        bool reachable = data[hierarchy[position].transform].isActive;
+        for (uint32_t ancestor = hierarchy[position].parent; reachable && ancestor != NO_PARENT;
+            ancestor = hierarchy[ancestor].parent) {
+            if (ancestor == DETACHED || hierarchy[ancestor].id == (EntityID)-1 ||
+                !data[hierarchy[ancestor].transform].isActive) {
+                reachable = false;
+            }
+            else if (hierarchy[ancestor].queued) {
+                covered = true;
+                break;
+            }
+        }
+        if (reachable && !covered)
+            subtreeStack.push_back(position);
+    }
+
+    for (uint32_t position : dirtyPositions) {
+        hierarchy[position].queued = false;
+    }
+    dirtyPositions.swap(subtreeStack);
+
+    updateLevel.resize(hierarchy.size());
+    updatePositions.clear();
+    uint32_t walkLimit = static_cast<uint32_t>(hierarchy.size()) / DIRTY_WALK_FRACTION;
+    for (uint32_t root : dirtyPositions) {
+        // korzenie są rozłączne, przodkowie już aktualni - każde poddrzewo liczone niezależnie
+        subtreeStack.clear();
+        subtreeStack.push_back(root);
+        updateLevel[root] = 0;
+        while (!subtreeStack.empty()) {
+            uint32_t position = subtreeStack.back();
+            subtreeStack.pop_back();
+
+            const HierarchyNode& node = hierarchy[position];
+            if (!data[node.transform].isActive)
+                continue;
+
+            // Duża część sceny brudna - liniowy przebieg po całej tablicy tańszy niż chodzenie po listach dzieci.
+            // isDirty korzeni zostało ustawione w markDirty, więc updateAll przeliczy te same poddrzewa.
+            if (updatePositions.size() >= walkLimit) {
+                updateAll(transforms, tick);
+                return;
+            }
+            // pre-order - rodzic na liście przed dziećmi
+            updatePositions.push_back(position);
+            for (EntityID child : infos.get(node.id).children) {
+                uint32_t childPosition = findPosition(child);
+                if (childPosition != NO_POSITION) {
+                    updateLevel[childPosition] = updateLevel[position] + 1;
+                    subtreeStack.push_back(childPosition);
+                }
+            }
+        }
+    }
+    recompute(transforms, tick);
+}
+
+void TransformSystem::recompute(ComponentStorage<Transform>& transforms, uint32_t tick) const {
+    Transform* data = transforms.components.data();
+    auto& jobSystem = JobSystem::GetInstance();
+    uint32_t count = static_cast<uint32_t>(updatePositions.size());
+
+    // macierze lokalne niezależne od siebie - liczone wsadowo, potem jedno mnożenie przez rodzica
+    updateTransforms.clear();
+    for (uint32_t position : updatePositions) {
+        updateTransforms.push_back(hierarchy[position].transform);
+    }
+    localMatrices.resize(count);
+
+    auto propagate = [&](uint32_t i) {
+        const HierarchyNode& node = hierarchy[updatePositions[i]];
+        Transform& transform = data[node.transform];
+
+        // rodzic przeliczony wcześniej (wcześniej na liście / niższy poziom) albo nie wymagał przeliczenia
+        if (node.parent != NO_PARENT) {
+            transform.globalMatrix = TransformKernels::multiplyAffine(
+                data[hierarchy[node.parent].transform].globalMatrix, localMatrices[i]);
+        }
+        else
+        {
+            transform.globalMatrix = localMatrices[i];
+        }
+
+        transforms.markChangedAt(node.transform, tick);
+        transform.isDirty = false;
+    };
+
+    // przy małej liczbie węzłów narzut zadań większy niż zysk
+    if (count < PARALLEL_MIN_NODES || jobSystem.getThreadCount() == 1) {
+        // paczkami - transformy paczki są jeszcze w cache, gdy propagate liczy ich macierze globalne
+        std::span<const uint32_t> indices = updateTransforms;
+        for (uint32_t first = 0; first < count; first += SERIAL_CHUNK) {
+            uint32_t last = std::min(first + SERIAL_CHUNK, count);
+            TransformKernels::composeLocalMatrices(data, indices.subspan(first, last - first), localMatrices.data() + first);
+            for (uint32_t i = first; i < last; i++) {
+                propagate(i);
+            }
+        }
+        return;
+    }
+
+    // podział w grupach po 4 - węzły trafiają do tej samej ścieżki (SSE/reszta) co w wersji jednowątkowej,
+    // więc wynik jest identyczny bit w bit
+    std::span<const uint32_t> indices = updateTransforms;
+    jobSystem.parallelFor((count + 3) / 4, PARALLEL_BATCH / 4, [&](uint32_t begin, uint32_t end) {
+        uint32_t first = begin * 4;
+        uint32_t last = std::min(end * 4, count);
+        TransformKernels::composeLocalMatrices(data, indices.subspan(first, last - first), localMatrices.data() + first);
+    });
+
+    // Poziomy głębokości (sortowanie przez zliczanie, stabilne): węzły jednego poziomu zależą tylko
+    // od poziomu wyższego, więc poziom dzielony jest na zadania, a poziomy idą po kolei.
+    // Szerokie poziomy (wiele poddrzew pod korzeniem sceny) rozkładają się równo niezależnie od
+    // wielkości poddrzew, wąskie (długie łańcuchy) parallelFor liczy od razu na bieżącym wątku.
+    levelOffsets.assign(1, 0);
+    for (uint32_t position : updatePositions) {
+        uint32_t level = updateLevel[position];
+        if (level + 2 > levelOffsets.size())
+            levelOffsets.resize(level + 2, 0);
+        levelOffsets[level + 1]++;
+    }
+    for (size_t level = 1; level < levelOffsets.size(); level++) {
+        levelOffsets[level] += levelOffsets[level - 1];
+    }
+    levelOrder.resize(count);
+    levelCursor.assign(levelOffsets.begin(), levelOffsets.end() - 1);
+    for (uint32_t i = 0; i < count; i++) {
+        levelOrder[levelCursor[updateLevel[updatePositions[i]]]++] = i;
+    }
+
+    for (size_t level = 0; level + 1 < levelOffsets.size(); level++) {
+        uint32_t levelBegin = levelOffsets[level];
+        jobSystem.parallelFor(levelOffsets[level + 1] - levelBegin, PARALLEL_BATCH, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t k = begin; k < end; k++) {
+                propagate(levelOrder[levelBegin + k]);
+            }
+        });
+    }
 }
 
 void TransformSystem::translateEntity(EntityID id, const glm::vec3& translation) const {
@@ -86,13 +489,13 @@ void TransformSystem::rotateEntity(EntityID id, const glm::quat& rotation) const
     auto& transform = scene->getComponent<Transform>(id);
     transform.rotation = rotation;
     //transform.eulerRotation = glm::degrees(glm::eulerAngles(rotation));
-	continuousQuatToEuler(transform.eulerRotation, rotation);
+	continuousQuatToEuler(scene->getComponent<TransformInfoComponent>(id).eulerRotation, rotation);
     markDirty(id);
 }
 
 void TransformSystem::rotateEntity(EntityID id, const glm::vec3& eulerRotation) const {
     auto& transform = scene->getComponent<Transform>(id);
-    transform.eulerRotation = eulerRotation;
+    scene->getComponent<TransformInfoComponent>(id).eulerRotation = eulerRotation;
     transform.rotation = glm::quat(glm::radians(eulerRotation));
     markDirty(id);
 }
@@ -101,7 +504,7 @@ void TransformSystem::rotateEntity(EntityID id, const glm::vec3& target, float d
     auto& transform = scene->getComponent<Transform>(id);
     glm::quat targetRotation = glm::quat(glm::radians(target));
     transform.rotation = glm::slerp(transform.rotation, targetRotation, delta);
-    continuousQuatToEuler(transform.eulerRotation, transform.rotation);
+    continuousQuatToEuler(scene->getComponent<TransformInfoComponent>(id).eulerRotation, transform.rotation);
     markDirty(id);
 }
 
@@ -117,7 +520,7 @@ void TransformSystem::setGlobalMatrix(EntityID id, const glm::mat4& mat) const {
 
     glm::mat4 parentMatrix = glm::mat4(1.0);
     if (transform.parent != -1) {
-        parentMatrix = scene->getComponent<Transform>(transform.parent).globalMatrix;
+        parentMatrix = scene->getStorage<Transform>()->get(transform.parent).globalMatrix;
     }
 
 
@@ -143,7 +546,7 @@ void TransformSystem::setGlobalMatrix(EntityID id, const glm::mat4& mat) const {
 
     transform.translation = position;
     //transform.eulerRotation = glm::degrees(glm::eulerAngles(rotation));
-	continuousQuatToEuler(transform.eulerRotation, rotation);
+	continuousQuatToEuler(scene->getComponent<TransformInfoComponent>(id).eulerRotation, rotation);
     transform.rotation = rotation;
     transform.scale = scale;
 
@@ -151,33 +554,104 @@ void TransformSystem::setGlobalMatrix(EntityID id, const glm::mat4& mat) const {
 }
 
 
+template<typename Apply>
+void TransformSystem::writeEntities(std::span<const EntityID> ids, Apply&& apply) const {
+    // storage i tick pobierane raz na całą partię
+    auto transforms = scene->getStorage<Transform>();
+    uint32_t tick = scene->getChangeTick();
+    for (size_t i = 0; i < ids.size(); i++) {
+        Transform& transform = transforms->getForWrite(ids[i], tick);
+        apply(i, transform);
+        markDirty(ids[i], transform);
+    }
+}
+
+void TransformSystem::translateEntities(std::span<const EntityID> ids, std::span<const glm::vec3> translations) const {
+    assert(ids.size() == translations.size() && "TransformSystem: ids and values differ in size");
+    writeEntities(ids, [&](size_t i, Transform& transform) {
+        transform.translation = translations[i];
+    });
+}
+
+void TransformSystem::rotateEntities(std::span<const EntityID> ids, std::span<const glm::quat> rotations) const {
+    assert(ids.size() == rotations.size() && "TransformSystem: ids and values differ in size");
+    auto infos = scene->getStorage<TransformInfoComponent>();
+    uint32_t tick = scene->getChangeTick();
+    writeEntities(ids, [&](size_t i, Transform& transform) {
+        transform.rotation = rotations[i];
+        continuousQuatToEuler(infos->getForWrite(ids[i], tick).eulerRotation, rotations[i]);
+    });
+}
+
+void TransformSystem::rotateEntities(std::span<const EntityID> ids, std::span<const glm::vec3> eulerRotations) const {
+    assert(ids.size() == eulerRotations.size() && "TransformSystem: ids and values differ in size");
+    auto infos = scene->getStorage<TransformInfoComponent>();
+    uint32_t tick = scene->getChangeTick();
+    writeEntities(ids, [&](size_t i, Transform& transform) {
+        infos->getForWrite(ids[i], tick).eulerRotation = eulerRotations[i];
+        transform.rotation = glm::quat(glm::radians(eulerRotations[i]));
+    });
+}
+
+void TransformSystem::scaleEntities(std::span<const EntityID> ids, std::span<const glm::vec3> scales) const {
+    assert(ids.size() == scales.size() && "TransformSystem: ids and values differ in size");
+    writeEntities(ids, [&](size_t i, Transform& transform) {
+        transform.scale = scales[i];
+    });
+}
+
+void TransformSystem::translateAndRotateEntities(std::span<const EntityID> ids, std::span<const glm::vec3> translations,
+    std::span<const glm::vec3> eulerRotations) const {
+    assert(ids.size() == translations.size() && ids.size() == eulerRotations.size() &&
+        "TransformSystem: ids and values differ in size");
+    auto infos = scene->getStorage<TransformInfoComponent>();
+    uint32_t tick = scene->getChangeTick();
+    writeEntities(ids, [&](size_t i, Transform& transform) {
+        transform.translation = translations[i];
+        infos->getForWrite(ids[i], tick).eulerRotation = eulerRotations[i];
+        transform.rotation = glm::quat(glm::radians(eulerRotations[i]));
+    });
+}
+
 void TransformSystem::markDirty(EntityID id) const {
-    auto& transform = scene->getComponent<Transform>(id);
+    markDirty(id, scene->getStorage<Transform>()->get(id));
+}
+
+void TransformSystem::markDirty(EntityID id, Transform& transform) const {
     transform.isDirty = true;
-    for (auto child : transform.children) {
-        markDirty(child);
+    if (!hierarchyValid || fullUpdate)
+        return;
+
+    uint32_t position = findPosition(id);
+    if (position == NO_POSITION) {
+        hierarchyValid = false;
+        return;
+    }
+    if (!hierarchy[position].queued) {
+        hierarchy[position].queued = true;
+        dirtyRoots.push_back(id);
     }
 }
 
 
 bool TransformSystem::addChild(EntityID parent, EntityID child) const {
-    auto& parentTransform = scene->getComponent<Transform>(parent);
+    auto& parentInfo = scene->getComponent<TransformInfoComponent>(parent);
     auto& childTransform = scene->getComponent<Transform>(child);
 
     if (childTransform.parent == parent)
         return false;
 
 	if (childTransform.parent != (EntityID)-1 &&
-        std::find(parentTransform.children.begin(), parentTransform.children.end(), child) != parentTransform.children.end())
+        std::find(parentInfo.children.begin(), parentInfo.children.end(), child) != parentInfo.children.end())
 		return false;
 
-    EntityID ancestor = parentTransform.id;
+    EntityID ancestor = parent;
 	while (ancestor != scene->getSceneRootEntity() && ancestor != (EntityID)-1) {
         if (ancestor == child) {
             return false;
         }
 
-        auto& ancestorTransform = scene->getComponent<Transform>(ancestor);
+        auto& ancestorTransform = scene->getStorage<Transform>()->get(ancestor);
         ancestor = ancestorTransform.parent;
     }
 
@@ -185,34 +659,76 @@ bool TransformSystem::addChild(EntityID parent, EntityID child) const {
         removeChild(childTransform.parent, child);
     }
 
-    parentTransform.children.push_back(child);
+    parentInfo.children.push_back(child);
     childTransform.parent = parent;
 
+    if (hierarchyValid) {
+        uint32_t parentPosition = findPosition(parent);
+        uint32_t childPosition = findPosition(child);
+        if (parentPosition == NO_POSITION || childPosition == NO_POSITION) {
+            hierarchyValid = false;
+        }
+        else if (parentPosition < childPosition) {
+            hierarchy[childPosition].parent = parentPosition;
+        }
+        else {
+            // nowy rodzic jest dalej w buforze - poddrzewo przenoszone na koniec
+            const Scene& constScene = *scene;
+            auto transforms = constScene.getStorage<Transform>();
+            auto infos = constScene.getStorage<TransformInfoComponent>();
+
+            std::vector<EntityID> stack{ child };
+            while (!stack.empty()) {
+                EntityID node = stack.back();
+                stack.pop_back();
+                uint32_t position = findPosition(node);
+                if (position == NO_POSITION)
+                    continue;
+                hierarchy[position].id = (EntityID)-1;
+                removedNodes++;
+                for (EntityID grandchild : infos->get(node).children) {
+                    stack.push_back(grandchild);
+                }
+            }
+            appendSubtree(*transforms, *infos, child, parentPosition);
+        }
+    }
+    // nowy rodzic - macierze poddrzewa do przeliczenia, także zmiany sprzed podpięcia
+    markDirty(child);
+
 	return true;
 }
 
 void TransformSystem::addChildKeepTransform(EntityID parent, EntityID child) const {
-	glm::mat4 globalMatrix = scene->getComponent<Transform>(child).globalMatrix;
+	glm::mat4 globalMatrix = scene->getStorage<Transform>()->get(child).globalMatrix;
 	if (addChild(parent, child))
 	    setGlobalMatrix(child, globalMatrix);
 }
 
 void TransformSystem::removeChild(EntityID parent, EntityID child) const {
-    auto& parentTransform = scene->getComponent<Transform>(parent);
+    auto& parentInfo = scene->getComponent<TransformInfoComponent>(parent);
     auto& childTransform = scene->getComponent<Transform>(child);
 
     if (childTransform.parent != parent)
         return;
 
-    std::erase(parentTransform.children, child);
+    std::erase(parentInfo.children, child);
     childTransform.parent = (EntityID) -1;
+
+    if (hierarchyValid) {
+        uint32_t position = findPosition(child);
+        if (position != NO_POSITION)
+            hierarchy[position].parent = DETACHED;
+        else
+            hierarchyValid = false;
+    }
 }
 
 void TransformSystem::setChildIndex(EntityID child, int index) const {
-	auto& childTransform = scene->getComponent<Transform>(child);
-	auto& parentTransform = scene->getComponent<Transform>(childTransform.parent);
+	EntityID parent = std::as_const(*scene).getComponent<Transform>(child).parent;
+	auto& parentInfo = scene->getComponent<TransformInfoComponent>(parent);
 
-	int currentIndex = std::find(parentTransform.children.begin(), parentTransform.children.end(), child) - parentTransform.children.begin();
+	int currentIndex = std::find(parentInfo.children.begin(), parentInfo.children.end(), child) - parentInfo.children.begin();
 	if (currentIndex == index)
 		return;
 
@@ -220,13 +736,15 @@ void TransformSystem::setChildIndex(EntityID child, int index) const {
 		index--;
 	}
 
-	std::erase(parentTransform.children, child);
-	parentTransform.children.insert(parentTransform.children.begin() + index, child);
+	std::erase(parentInfo.children, child);
+	parentInfo.children.insert(parentInfo.children.begin() + index, child);
+	// kolejność rodzeństwa nie wpływa na bufor hierarchii - wystarcza rodzic przed dzieckiem
 }
 
 int TransformSystem::getChildIndex(EntityID child) const {
-    auto& childTransform = scene->getComponent<Transform>(child);
-    auto& parentTransform = scene->getComponent<Transform>(childTransform.parent);
+    const Scene& constScene = *scene;
+    EntityID parent = constScene.getComponent<Transform>(child).parent;
+    auto& parentInfo = constScene.getComponent<TransformInfoComponent>(parent);
 
-	return std::find(parentTransform.children.begin(), parentTransform.children.end(), child) - parentTransform.children.begin();
-}
\ No newline at end of file
+	return std::find(parentInfo.children.begin(), parentInfo.children.end(), child) - parentInfo.children.begin();
+}
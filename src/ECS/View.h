@@ -0,0 +1,94 @@
+#ifndef PBL_VIEW_H
+#define PBL_VIEW_H
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "ComponentStorage.h"
+
+// View<const T> czyta przez const ComponentStorage<T> (np. z const Scene&)
+template<typename T>
+using ViewStorage = std::conditional_t<std::is_const_v<T>,
+    const ComponentStorage<std::remove_const_t<T>>, ComponentStorage<T>>;
+
+// Widok na encje posiadające wszystkie komponenty Ts...
+// Storage są pobierane raz przy tworzeniu widoku, iteracja idzie po najmniejszym z nich.
+// Usuwanie komponentów typu prowadzącego w trakcie iteracji może pominąć encję (jak przy ręcznej pętli).
+template<typename... Ts>
+class View {
+    static_assert(sizeof...(Ts) > 0, "View needs at least one component type");
+
+public:
+    explicit View(ViewStorage<Ts>*... s) : storages(s...) {
+        valid = ((s != nullptr) && ...);
+        if (!valid) return;
+
+        uint32_t smallest = UINT32_MAX;
+        size_t i = 0;
+        ((s->getQuantity() < smallest ? (smallest = s->getQuantity(), driver = i++) : i++), ...);
+    }
+
+    // callback: (EntityID, Ts&...), dla const Ts - referencje const
+    template<typename Func>
+    void each(Func&& func) const {
+        if (!valid) return;
+        eachImpl(std::forward<Func>(func), std::index_sequence_for<Ts...>{});
+    }
+
+    bool contains(EntityID id) const {
+        return valid && (std::get<ViewStorage<Ts>*>(storages)->has(id) && ...);
+    }
+
+    template<typename T>
+    decltype(auto) get(EntityID id) const {
+        return std::get<StorageOf<T>*>(storages)->get(id);
+    }
+
+    template<typename T>
+    bool changedSince(EntityID id, uint32_t tick) const {
+        return std::get<StorageOf<T>*>(storages)->changedSince(id, tick);
+    }
+
+    // zapisy przez widok nie są śledzone automatycznie
+    template<typename T>
+    void markChanged(EntityID id, uint32_t tick) const {
+        std::get<StorageOf<T>*>(storages)->markChanged(id, tick);
+    }
+
+    // górne ograniczenie liczby encji w widoku
+    uint32_t sizeHint() const {
+        if (!valid) return 0;
+        uint32_t size = 0;
+        visitDriver([&](auto* storage) { size = storage->getQuantity(); }, std::index_sequence_for<Ts...>{});
+        return size;
+    }
+
+private:
+    // get<Transform> na widoku View<const Transform> trafia w storage const
+    template<typename T>
+    using StorageOf = ViewStorage<std::conditional_t<(std::is_same_v<const std::remove_const_t<T>, Ts> || ...),
+        const std::remove_const_t<T>, std::remove_const_t<T>>>;
+
+    std::tuple<ViewStorage<Ts>*...> storages;
+    size_t driver = 0;
+    bool valid = false;
+
+    template<typename Func, size_t... Is>
+    void visitDriver(Func&& func, std::index_sequence<Is...>) const {
+        ((driver == Is ? (func(std::get<Is>(storages)), true) : false) || ...);
+    }
+
+    template<typename Func, size_t... Is>
+    void eachImpl(Func&& func, std::index_sequence<Is...> seq) const {
+        visitDriver([&](auto* lead) {
+            for (uint32_t i = 0; i < lead->getQuantity(); i++) {
+                EntityID id = lead->components[i].id;
+                if (!(std::get<Is>(storages)->has(id) && ...)) continue;
+                func(id, std::get<Is>(storages)->get(id)...);
+            }
+        }, seq);
+    }
+};
+
+#endif //PBL_VIEW_H
@@ -2,9 +2,8 @@
 #include <glm/glm.hpp>
 #include "Scene.h"
 
-void BreadController::update(GLFWwindow* window, Scene* scene, float deltaTime)
+void BreadController::update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites)
 {
-	auto& transformSystem = scene->getTransformSystem();
 
 
 	
@@ -28,22 +27,22 @@ void BreadController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 		if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
 		{
 			movement.z -= moveSpeed * freezeFactor;
-			transformSystem.rotateEntity(id, glm::vec3(0.0f, 0.0f, 0.0f), deltaTime*10 * rotMul);
+			transformWrites.rotate(id, glm::vec3(0.0f, 0.0f, 0.0f), deltaTime*10 * rotMul);
 		}
 		if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
 		{
 			movement.z += moveSpeed * freezeFactor;
-			transformSystem.rotateEntity(id, glm::vec3(0.0f, 180.0f, 0.0f), deltaTime*10 * rotMul);
+			transformWrites.rotate(id, glm::vec3(0.0f, 180.0f, 0.0f), deltaTime*10 * rotMul);
 		}
 		if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
 		{
 			movement.x -= moveSpeed * freezeFactor;
-			transformSystem.rotateEntity(id, -glm::vec3(0.0f, 270.0f, 0.0f), deltaTime*10 * rotMul);
+			transformWrites.rotate(id, -glm::vec3(0.0f, 270.0f, 0.0f), deltaTime*10 * rotMul);
 		}
 		if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
 		{
 			movement.x += moveSpeed * freezeFactor;
-			transformSystem.rotateEntity(id, -glm::vec3(0.0f, 90.0f, 0.0f), deltaTime*10 * rotMul);
+			transformWrites.rotate(id, -glm::vec3(0.0f, 90.0f, 0.0f), deltaTime*10 * rotMul);
 		}
 
 		if (glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS)
@@ -53,7 +52,7 @@ void BreadController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 				relativeScale += deltaTime * 0.8f;
 				relativeScale = glm::clamp(relativeScale, 1.0f, 1.25f);
 
-				transformSystem.scaleEntity(id, startScale * relativeScale);
+				transformWrites.scale(id, startScale * relativeScale);
 				isBouncy = true;
 			}
 		}
@@ -64,7 +63,7 @@ void BreadController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 				relativeScale -= deltaTime * 0.8f;
 				relativeScale = glm::clamp(relativeScale, 1.0f, 1.25f);
 
-				transformSystem.scaleEntity(id, startScale * relativeScale);
+				transformWrites.scale(id, startScale * relativeScale);
 				isBouncy = false;
 			}
 		}
@@ -3,6 +3,7 @@
 #include "ECS/EntityManager.h"
 #include <glm/glm.hpp>
 class Scene;
+class TransformWriteQueue;
 
 struct BreadController {
 	float moveSpeed;
@@ -17,6 +18,6 @@ struct BreadController {
 	glm::vec3 startScale = { 1.0f, 1.0f, 1.0f };
 	float relativeScale = 1.0f;
 	bool isBouncy = false;
-	void update(GLFWwindow* window, Scene* scene, float deltaTime);
+	void update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites);
 	EntityID id = (EntityID)-1;
 };
\ No newline at end of file
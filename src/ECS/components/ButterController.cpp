@@ -4,9 +4,8 @@
 #include "Scene.h"
 #include "spdlog/spdlog.h"
 
-void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime)
+void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites)
 {
-	auto& transformSystem = scene->getTransformSystem();
 	if (trailBurstLeft > 0.f)
 	{
 		const float SPAWN_EVERY = 0.05f;     
@@ -23,27 +22,27 @@ void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 	if (scene->hasComponent<VelocityComponent>(id))
 	{
 		auto& velocityComponent = scene->getComponent<VelocityComponent>(id);
-        auto& transform = scene->getComponent<Transform>(id);
+        const Transform& transform = std::as_const(*scene).getComponent<Transform>(id);
 		glm::vec3 movement(0.0f, 0.0f, 0.0f);
 		if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
 		{
 			movement.z -= moveSpeed;
-			transformSystem.rotateEntity(id, glm::vec3(0.0f, 0.0f, 0.0f), deltaTime*10);
+			transformWrites.rotate(id, glm::vec3(0.0f, 0.0f, 0.0f), deltaTime*10);
 		}
 		if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
 		{
 			movement.z += moveSpeed;
-			transformSystem.rotateEntity(id, glm::vec3(0.0f, 180.0f, 0.0f), deltaTime*10);
+			transformWrites.rotate(id, glm::vec3(0.0f, 180.0f, 0.0f), deltaTime*10);
 		}
 		if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
 		{
 			movement.x -= moveSpeed;
-			transformSystem.rotateEntity(id, -glm::vec3(0.0f, 270.0f, 0.0f), deltaTime*10);
+			transformWrites.rotate(id, -glm::vec3(0.0f, 270.0f, 0.0f), deltaTime*10);
 		}
 		if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
 		{
 			movement.x += moveSpeed;
-			transformSystem.rotateEntity(id, -glm::vec3(0.0f, 90.0f, 0.0f), deltaTime*10);
+			transformWrites.rotate(id, -glm::vec3(0.0f, 90.0f, 0.0f), deltaTime*10);
 		}
 
 		if (glm::length(movement) > 0.0f)
@@ -95,7 +94,7 @@ void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 		velocityComponent.velocity = movement;
 
         if(transform.translation.y<-9.5){
-            transformSystem.translateEntity(id, scene->getComponent<Transform>(respawnPoint).translation);
+            transformWrites.translate(id, std::as_const(*scene).getComponent<Transform>(respawnPoint).translation);
         }
 
 
@@ -116,17 +115,17 @@ void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 }
 	void ButterController::addTrailIfPossible(Scene * scene)
 	{
-		auto& transformSystem = scene->getTransformSystem();
-		auto& transform = scene->getComponent<Transform>(id);
+		const Transform& transform = std::as_const(*scene).getComponent<Transform>(id);
 
 	
 		bool addTrail = (timeSinceLastGroundContact <= 0.1f);
 
 		
-		if (addTrail && !trailEntities.empty())
+		// ślad mógł zostać zniszczony z zewnątrz - nieaktualne ID odrzucamy po wersji
+		EntityID lastTrail = trailCount > 0 ? trailEntities[(firstTrail + trailCount - 1) % MAX_TRAILS] : (EntityID)-1;
+		if (addTrail && trailCount > 0 && scene->hasEntity(lastTrail))
 		{
-			EntityID lastTrail = trailEntities.back();
-			auto& lastTransform = scene->getComponent<Transform>(lastTrail);
+			const Transform& lastTransform = std::as_const(*scene).getComponent<Transform>(lastTrail);
 			if (glm::length(lastTransform.translation - transform.translation) < 0.3f)
 				addTrail = false;
 		}
@@ -134,26 +133,45 @@ void ButterController::update(GLFWwindow* window, Scene* scene, float deltaTime)
 		if (!addTrail) return;
 
 		
-		EntityID trail = scene->instantiatePrefab("Trail")[0];
+		// ślad powstaje przy playback bufora komend - bez zmian storage w trakcie iteracji po kontrolerach
+		glm::quat butterRotation = transform.rotation;
 
 		float offsetScale = 1.0f;
 		if (scene->hasComponent<ButterHealthComponent>(id))
 		{
-			auto& bh = scene->getComponent<ButterHealthComponent>(id);
+			const auto& bh = std::as_const(*scene).getComponent<ButterHealthComponent>(id);
 			float lostRatio = 1.0f - (bh.timeLeft / bh.secondsToDie);
 			offsetScale = glm::mix(1.0f, bh.minScale, lostRatio);
 		}
 
-		transformSystem.translateEntity(trail,
-			transform.translation - glm::vec3(0.0f, 0.22f * offsetScale, 0.0f));
-		transformSystem.rotateEntity(trail, transform.rotation);
-
-		
-		trailEntities.push(trail);
-		if (trailEntities.size() > 200)
-		{
-			EntityID oldTrail = trailEntities.front();
-			trailEntities.pop();
-			scene->destroyEntity(oldTrail);
-		}
+		glm::vec3 trailTranslation = transform.translation - glm::vec3(0.0f, 0.22f * offsetScale, 0.0f);
+		EntityID butter = id;
+		// lambda mieści się w buforze Delegate (32 B) - bez alokacji przy każdym śladzie
+		scene->getCommandBuffer().acquirePooled(scene->findPrefab("Trail"), (EntityID)-1,
+			[butter, trailTranslation, butterRotation](Scene& scene, const std::vector<EntityID>& spawned)
+			{
+				if (spawned.empty()) return;
+				EntityID trail = spawned[0];
+
+				auto& transformSystem = scene.getTransformSystem();
+				transformSystem.translateEntity(trail, trailTranslation);
+				transformSystem.rotateEntity(trail, butterRotation);
+
+				if (!scene.hasComponent<ButterController>(butter))
+					return;
+
+				auto& controller = scene.getComponent<ButterController>(butter);
+				if (controller.trailCount < MAX_TRAILS)
+				{
+					controller.trailEntities[(controller.firstTrail + controller.trailCount) % MAX_TRAILS] = trail;
+					controller.trailCount++;
+					return;
+				}
+
+				EntityID oldTrail = controller.trailEntities[controller.firstTrail];
+				controller.trailEntities[controller.firstTrail] = trail;
+				controller.firstTrail = (controller.firstTrail + 1) % MAX_TRAILS;
+				// wraca do puli - następny ślad użyje tej samej encji
+				scene.getEntityPool().release(oldTrail);
+			});
 	}
\ No newline at end of file
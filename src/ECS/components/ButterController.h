@@ -1,9 +1,10 @@
 #pragma once
 #include "glfw/glfw3.h"
 #include "ECS/EntityManager.h"
-#include <queue>
+#include <array>
 
 class Scene;
+class TransformWriteQueue;
 
 
 struct ButterController
@@ -14,7 +15,11 @@ struct ButterController
 	float timeSinceLastGroundContact = 0.0f;
     EntityID respawnPoint = (EntityID)-1;
 
-	std::queue<EntityID> trailEntities;
+	// ostatnie ślady w buforze cyklicznym - po zapełnieniu najstarszy wraca do puli
+	static constexpr uint32_t MAX_TRAILS = 200;
+	std::array<EntityID, MAX_TRAILS> trailEntities{};
+	uint32_t firstTrail = 0;
+	uint32_t trailCount = 0;
 
 	bool  inHeat = false;  
 	bool  wasInHeat = false;   
@@ -24,7 +29,7 @@ struct ButterController
 	bool floating = false;
 
 
-	void update(GLFWwindow* window, Scene* scene, float deltaTime);
+	void update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites);
 
 	void addTrailIfPossible(Scene* scene);
 
@@ -51,5 +51,4 @@ void CameraComponent::updateProjectionMatrix() {
 	}
 
 	camera.getFrustum().setProjectionMatrix(projectionMatrix);
-	dirty = false;
 }
\ No newline at end of file
@@ -9,8 +9,6 @@ struct CameraComponent {
 	Camera camera;
 	EntityID id = (EntityID)-1;
 
-	bool dirty = true;
-
 	float aspectRatio = 16.0f / 9.0f;
 
 	float nearPlane = 0.1f;
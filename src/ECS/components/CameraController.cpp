@@ -5,15 +5,14 @@
 #include "CameraController.h"
 #include "Scene.h"
 
-void CameraController::update(GLFWwindow *window, Scene *scene, float deltaTime) {
-    Transform targetTransform = scene->getComponent<Transform>(targetID);
-    auto& transformSystem = scene->getTransformSystem();
+void CameraController::update(GLFWwindow *window, Scene *scene, float deltaTime, TransformWriteQueue& transformWrites) {
+    const Transform& targetTransform = std::as_const(*scene).getComponent<Transform>(targetID);
 
 
     glm::vec3 cameraPos = targetTransform.translation + offset;
 
     // Update camera position
-    transformSystem.translateEntity(id, cameraPos);
+    transformWrites.translate(id, cameraPos);
 
     // // Optionally, you can also update the camera rotation to look at the target
     glm::vec3 direction = -glm::normalize(cameraPos - targetTransform.translation);
@@ -21,5 +20,5 @@ void CameraController::update(GLFWwindow *window, Scene *scene, float deltaTime)
     glm::vec3 right = glm::normalize(glm::cross(direction, up));
     up = glm::normalize(glm::cross(right, direction));
 
-    transformSystem.rotateEntity(id, glm::quatLookAt(direction, up));
+    transformWrites.rotate(id, glm::quatLookAt(direction, up));
 }
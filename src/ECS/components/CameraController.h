@@ -10,6 +10,7 @@
 
 
 class Scene;
+class TransformWriteQueue;
 
 
 struct CameraController
@@ -17,7 +18,7 @@ struct CameraController
     EntityID targetID;
     glm::vec3 offset = {0.0f, 2.0f, 5.0f};
 
-    void update(GLFWwindow* window, Scene* scene, float deltaTime);
+    void update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites);
 
 
     EntityID id = (EntityID)-1;
@@ -2,7 +2,7 @@
 #include "Scene.h"
 #include "spdlog/spdlog.h"
 
-void SplitScreenController::update(GLFWwindow* window, Scene* scene, float deltaTime) {
+void SplitScreenController::update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites) {
 	if (target1 == (EntityID)-1 || target2 == (EntityID)-1 ||
 		camera1 == (EntityID)-1 || camera2 == (EntityID)-1) {
 		return;
@@ -12,11 +12,12 @@ void SplitScreenController::update(GLFWwindow* window, Scene* scene, float delta
 		return;
 	}
 
-	auto& ts = scene->getTransformSystem();
-	Transform& targetTransform1 = scene->getComponent<Transform>(target1);
-	Transform& targetTransform2 = scene->getComponent<Transform>(target2);
-	Transform& sscTransform = scene->getComponent<Transform>(id);
-	ts.translateEntity(id, (targetTransform1.translation + targetTransform2.translation) / 2.0f);
+	// tylko odczyt - zapis idzie przez kolejkę, więc nowa pozycja kontrolera jest liczona lokalnie
+	const Scene& constScene = *scene;
+	const Transform& targetTransform1 = constScene.getComponent<Transform>(target1);
+	const Transform& targetTransform2 = constScene.getComponent<Transform>(target2);
+	glm::vec3 sscTranslation = (targetTransform1.translation + targetTransform2.translation) / 2.0f;
+	transformWrites.translate(id, sscTranslation);
 
 
 	glm::vec3 direction = -glm::normalize(offset);
@@ -25,15 +26,15 @@ void SplitScreenController::update(GLFWwindow* window, Scene* scene, float delta
 	up = glm::normalize(glm::cross(right, direction));
 	glm::quat rotation = glm::quatLookAt(direction, up);
 
-	glm::vec3 cameraPos = sscTransform.translation + offset;
+	glm::vec3 cameraPos = sscTranslation + offset;
 	
 	float dist = glm::distance(targetTransform1.translation, targetTransform2.translation);
 
 
 	if (dist < 8.0f)
 	{
-		ts.translateEntity(camera1, cameraPos);
-		ts.translateEntity(camera2, cameraPos);
+		transformWrites.translate(camera1, cameraPos);
+		transformWrites.translate(camera2, cameraPos);
 
 		splitActive = false;
 	}
@@ -59,8 +60,8 @@ void SplitScreenController::update(GLFWwindow* window, Scene* scene, float delta
 		glm::vec3 newCamera1Pos = glm::mix(cameraPos, camera1TagetPos, mixFactor);
 		glm::vec3 newCamera2Pos = glm::mix(cameraPos, camera2TargetPos, mixFactor);
 
-		ts.translateEntity(camera1, newCamera1Pos);
-		ts.translateEntity(camera2, newCamera2Pos);
+		transformWrites.translate(camera1, newCamera1Pos);
+		transformWrites.translate(camera2, newCamera2Pos);
 
 		auto& cam1Component = scene->getComponent<CameraComponent>(camera1);
 		auto& cam2Component = scene->getComponent<CameraComponent>(camera2);
@@ -75,12 +76,12 @@ void SplitScreenController::update(GLFWwindow* window, Scene* scene, float delta
 		cam2Component.updateProjectionMatrix();
 
 		target1AboveSlope = (targetTransform1.translation.z - 
-			(splitSlope * (targetTransform1.translation.x - sscTransform.translation.x) + sscTransform.translation.z)) < 0.0f;
+			(splitSlope * (targetTransform1.translation.x - sscTranslation.x) + sscTranslation.z)) < 0.0f;
 		splitActive = true;
 		splitLineThickness = 5.0f * mixFactor;
 	}
-	ts.rotateEntity(camera1, rotation);
-	ts.rotateEntity(camera2, rotation);
+	transformWrites.rotate(camera1, rotation);
+	transformWrites.rotate(camera2, rotation);
 	
 
 }
@@ -5,6 +5,7 @@
 #include "glm/glm.hpp"
 
 class Scene;
+class TransformWriteQueue;
 
 struct SplitScreenController
 {
@@ -23,7 +24,7 @@ struct SplitScreenController
 
     glm::vec3 offset = { 0.0f, 2.0f, 5.0f };
 
-    void update(GLFWwindow* window, Scene* scene, float deltaTime);
+    void update(GLFWwindow* window, Scene* scene, float deltaTime, TransformWriteQueue& transformWrites);
 
 
     EntityID id = (EntityID)-1;
@@ -263,6 +263,10 @@ namespace Editor
             {
                 ImGui::BeginTooltip();
                 ImGui::Text("Average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
+                for (const auto& timing : systemScheduler.getTimings())
+                {
+                    ImGui::Text("%s: %.3f ms (+%.3f ms)", timing.name.c_str(), timing.milliseconds, timing.startMilliseconds);
+                }
                 ImGui::EndTooltip();
             }
 
@@ -309,6 +313,7 @@ namespace Editor
 
 		if (mode == PlayMode::PLAY && playMode == PlayMode::STOP)
         {
+            // storage są współdzielone, kopiowane dopiero przy pierwszym zapisie w trybie gry
             sceneBackup = std::make_shared<Scene>(*scene);
 			ImGui::SetWindowFocus("Game");
 			scene->getRenderingSystem().buildTree();
@@ -320,17 +325,20 @@ namespace Editor
 		{
 			if (sceneBackup)
             {
+                // odczyt przez const - nie odłączamy storage współdzielonych z kopią
+                const Scene& playScene = *scene;
+                const Scene& backup = *sceneBackup;
                 if (selectedObject != (EntityID)-1)
                 {
-                    std::string& selectedObjectUuid = scene->getComponent<ObjectInfoComponent>(selectedObject).uuid;
-                    if (!sceneBackup->hasEntity(selectedObject) || sceneBackup->getComponent<ObjectInfoComponent>(selectedObject).uuid != selectedObjectUuid)
+                    if (!playScene.hasEntity(selectedObject) || !backup.hasEntity(selectedObject) ||
+                        backup.getComponent<ObjectInfoComponent>(selectedObject).uuid != playScene.getComponent<ObjectInfoComponent>(selectedObject).uuid)
                     {
                         selectedObject = (EntityID)-1;
                     }
                 }
 
-                scene = std::make_shared<Scene>(*sceneBackup);
-                setupEvents();
+                // ta sama scena - listenery z setupEvents() zostają, bez budowania EventSystem od nowa
+                scene->restoreFrom(*sceneBackup);
                 sceneBackup = nullptr;
             }
 			ImGui::SetWindowFocus("Scene");
@@ -420,7 +428,7 @@ namespace Editor
 		    ImGui::BeginDisabled(!prefabExists);
 		    if (ImGui::Button("Instantiate"))
 		    {
-			    auto instantiatedEntities = Serialization::deserializeObjects(it->second, *scene, selectedObject, { shaders, models, false });
+			    auto instantiatedEntities = instantiatePrefab(prefabName, *scene, selectedObject);
 			    /*if (!instantiatedEntities.empty())
 			    {
 				    selectedObject = instantiatedEntities[0];
@@ -433,6 +441,7 @@ namespace Editor
             if (ImGui::Button(prefabExists ? "Update" : "Create"))
             {
                 prefabs[prefabName] = Serialization::serializeObjects({ selectedObject }, *scene);
+                compilePrefab(prefabName);
 
 				// TODO?: osobne pliki dla każdego prefabu
 				std::ofstream prefabFile("res/prefabs.json");
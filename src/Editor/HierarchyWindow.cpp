@@ -38,7 +38,7 @@ namespace Editor
                     if (ImGui::MenuItem("Add Object"))
                     {
                         EntityID newObject = scene->createEntity(root);
-                        scene->getComponent<ObjectInfoComponent>(newObject).name = "New Object";
+                        scene->setEntityName(newObject, "New Object");
 						editor->selectedObject = newObject;
                     }
 
@@ -59,16 +59,19 @@ namespace Editor
 
         ImGui::PushID(id);
 
-        std::string objName = scene->getComponent<ObjectInfoComponent>(id).name;
+        // tylko odczyt - zapis przez getComponent oznaczałby co klatkę każdy rysowany węzeł jako zmieniony
+        const Scene& constScene = *scene;
+        std::string objName = constScene.getComponent<ObjectInfoComponent>(id).name;
         std::string displayName = objName + "###objName";
-        Transform& transform = scene->getComponent<Transform>(id);
+        const Transform& transform = constScene.getComponent<Transform>(id);
+        const auto& transformInfo = constScene.getComponent<TransformInfoComponent>(id);
 		auto& ts = scene->getTransformSystem();
 
 
         ImGuiTreeNodeFlags nodeFlags = ImGuiTreeNodeFlags_OpenOnArrow | ImGuiTreeNodeFlags_SpanAvailWidth 
             | ImGuiTreeNodeFlags_FramePadding;
 
-        nodeFlags |= (transform.children.size() == 0) ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_DefaultOpen;
+        nodeFlags |= (transformInfo.children.size() == 0) ? ImGuiTreeNodeFlags_Leaf : ImGuiTreeNodeFlags_DefaultOpen;
         if (id == editor->selectedObject)
             nodeFlags |= ImGuiTreeNodeFlags_Selected;
 
@@ -111,6 +114,9 @@ namespace Editor
 
             if (id != scene->getSceneRootEntity())
             {
+                // deserializacja dodaje komponenty - referencja do transformu może się unieważnić
+                EntityID parent = transform.parent;
+
                 if (ImGui::MenuItem("Copy"))
                 {
                     json objectJson = Serialization::serializeObjects({ id }, *scene);
@@ -125,12 +131,12 @@ namespace Editor
                         {
                             json objectJson = editor->clipboard.objectJson;
                             auto pastedEntities = Serialization::deserializeObjects(objectJson, *scene,
-                                transform.parent, { context.shaders, context.models, false });
+                                parent, { context.shaders, context.models, false });
 
                             int index = ts.getChildIndex(id);
                             for (auto& entity : pastedEntities)
                             {
-                                if (scene->getComponent<Transform>(entity).parent == transform.parent)
+                                if (constScene.getComponent<Transform>(entity).parent == parent)
                                 {
                                     ts.setChildIndex(entity, index + 1);
                                     Utils::setUniqueName(entity, *scene);
@@ -162,11 +168,11 @@ namespace Editor
                 {
                     json objectJson = Serialization::serializeObjects({ id }, *scene);
                     auto pastedEntities = Serialization::deserializeObjects(objectJson, *scene,
-                        transform.parent, { context.shaders, context.models, false });
+                        parent, { context.shaders, context.models, false });
 
                     for (auto& entity : pastedEntities)
                     {
-                        if (scene->getComponent<Transform>(entity).parent == transform.parent)
+                        if (constScene.getComponent<Transform>(entity).parent == parent)
                         {
                             ts.setChildIndex(entity, ts.getChildIndex(id) + 1);
                             Utils::setUniqueName(entity, *scene);
@@ -204,14 +210,14 @@ namespace Editor
 
         if (opened)
         {
-            if (transform.children.size() > 0)
+            if (transformInfo.children.size() > 0)
             {
-                for (int i = 0; i < transform.children.size(); i++)
+                for (int i = 0; i < transformInfo.children.size(); i++)
                 {
                     drawRearrangeTarget(context, id, i);
-                    drawNode(context, transform.children[i]);
+                    drawNode(context, transformInfo.children[i]);
                 }
-                drawRearrangeTarget(context, id, transform.children.size());
+                drawRearrangeTarget(context, id, transformInfo.children.size());
             }
 
             ImGui::TreePop();
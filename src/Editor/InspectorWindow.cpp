@@ -48,13 +48,13 @@ namespace Editor
             if (editor->selectedObject != (EntityID)-1)
             {
                 assert(scene->hasComponent<ObjectInfoComponent>(editor->selectedObject));
-                auto& objectInfo = scene->getComponent<ObjectInfoComponent>(editor->selectedObject);
+                const auto& objectInfo = std::as_const(*scene).getComponent<ObjectInfoComponent>(editor->selectedObject);
                 std::string objName = objectInfo.name;
                 const char* name = objName.c_str();
 
                 if (ImGui::InputText("Name", (char*)name, 64))
                 {
-                    objectInfo.name = name;
+                    scene->setEntityName(editor->selectedObject, name);
                 }
                 if (editor->selectedObject == scene->getSceneRootEntity())
                 {
@@ -66,7 +66,7 @@ namespace Editor
 
                 if (ImGui::InputText("Tag", (char*)tagCStr, 64))
                 {
-                    objectInfo.tag = tagCStr;
+                    scene->setEntityTag(editor->selectedObject, tagCStr);
                 }
 
                 ImGui::Separator();
@@ -145,17 +145,23 @@ namespace Editor
             return;
 
         auto& ts = scene->getTransformSystem();
-        auto& transform = scene->getComponent<Transform>(id);
+        // odczyt przez const Scene - komponent oznaczany jako zmieniony dopiero przy faktycznej edycji
+        const Scene& constScene = *scene;
+        const auto& transform = constScene.getComponent<Transform>(id);
 
         ImGui::PushID(&transform);
 
         if (ImGui::CollapsingHeader("Transform", ImGuiTreeNodeFlags_DefaultOpen))
         {
             glm::vec3 translation = transform.translation;
-            glm::vec3 rotation = transform.eulerRotation;
+            glm::vec3 rotation = constScene.getComponent<TransformInfoComponent>(id).eulerRotation;
             glm::vec3 scale = transform.scale;
 
-			ImGui::Checkbox("Static", &transform.isStatic);
+			bool isStatic = transform.isStatic;
+			if (ImGui::Checkbox("Static", &isStatic))
+			{
+				scene->getComponent<Transform>(id).isStatic = isStatic;
+			}
 
             if (ImGui::DragFloat3("Position", &translation[0], 0.1f))
             {
@@ -241,7 +247,7 @@ namespace Editor
         if (!scene->hasComponent<ModelComponent>(id))
             return;
 
-        auto& modelComponent = scene->getComponent<ModelComponent>(id);
+        const auto& modelComponent = std::as_const(*scene).getComponent<ModelComponent>(id);
         ImGui::PushID(&modelComponent);
 
         bool open = ImGui::CollapsingHeader("Model", ImGuiTreeNodeFlags_DefaultOpen);
@@ -257,7 +263,7 @@ namespace Editor
                     if (ImGui::Selectable(context.models[i]->path.c_str(), model == context.models[i]))
                     {
                         model = context.models[i];
-                        modelComponent.model = model;
+                        scene->getComponent<ModelComponent>(id).model = model;
                     }
                 }
                 ImGui::EndCombo();
@@ -271,14 +277,18 @@ namespace Editor
                     if (ImGui::Selectable(shaders[i]->getName().c_str(), modelShader == shaders[i]))
                     {
                         modelShader = shaders[i];
-                        modelComponent.shader = modelShader;
+                        scene->getComponent<ModelComponent>(id).shader = modelShader;
                     }
                 }
 
                 ImGui::EndCombo();
             }
 
-			ImGui::ColorEdit3("Color", &modelComponent.color[0]);
+			glm::vec3 color = modelComponent.color;
+			if (ImGui::ColorEdit3("Color", &color[0]))
+			{
+				scene->getComponent<ModelComponent>(id).color = color;
+			}
         }
 
 
@@ -312,13 +322,11 @@ namespace Editor
                     cameraComponent.projectionType == CameraComponent::ProjectionType::PERSPECTIVE))
                 {
                     cameraComponent.projectionType = CameraComponent::ProjectionType::PERSPECTIVE;
-                    cameraComponent.dirty = true;
                 }
                 if (ImGui::Selectable("Orthographic",
                     cameraComponent.projectionType == CameraComponent::ProjectionType::ORTHOGRAPHIC))
                 {
                     cameraComponent.projectionType = CameraComponent::ProjectionType::ORTHOGRAPHIC;
-                    cameraComponent.dirty = true;
                 }
                 ImGui::EndCombo();
             }
@@ -335,13 +343,11 @@ namespace Editor
                     cameraComponent.fovSizeAxis == CameraComponent::FovSizeAxis::VERTICAL))
                 {
                     cameraComponent.fovSizeAxis = CameraComponent::FovSizeAxis::VERTICAL;
-                    cameraComponent.dirty = true;
                 }
                 if (ImGui::Selectable("Horizontal",
                     cameraComponent.fovSizeAxis == CameraComponent::FovSizeAxis::HORIZONTAL))
                 {
                     cameraComponent.fovSizeAxis = CameraComponent::FovSizeAxis::HORIZONTAL;
-                    cameraComponent.dirty = true;
                 }
                 ImGui::EndCombo();
             }
@@ -352,21 +358,20 @@ namespace Editor
                 if (ImGui::SliderFloat("Field of View", &fovDeg, 1e-05f, 179.9f, "%.2f"))
                 {
                     cameraComponent.perspective.fov = glm::radians(fovDeg);
-                    cameraComponent.dirty = true;
                 }
             }
             else
             {
-                cameraComponent.dirty |= ImGui::DragFloat("Size", &cameraComponent.orthographic.size, 0.1f);
+                ImGui::DragFloat("Size", &cameraComponent.orthographic.size, 0.1f);
             }
 
-            cameraComponent.dirty |= ImGui::DragFloat2("Screen Offset", &cameraComponent.screenOffset[0],
+            ImGui::DragFloat2("Screen Offset", &cameraComponent.screenOffset[0],
                 0.01f, -1.0f, 1.0f);
 
             ImGui::SeparatorText("Clipping Planes");
-            cameraComponent.dirty |= ImGui::DragFloat("Near", &cameraComponent.nearPlane,
+            ImGui::DragFloat("Near", &cameraComponent.nearPlane,
                 0.01f, 0.01f, cameraComponent.farPlane - 0.01f);
-            cameraComponent.dirty |= ImGui::DragFloat("Far", &cameraComponent.farPlane,
+            ImGui::DragFloat("Far", &cameraComponent.farPlane,
                 0.01f, cameraComponent.nearPlane + 0.01f, 10000.0f);
 
             ImGui::Unindent();
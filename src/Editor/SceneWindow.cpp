@@ -26,12 +26,12 @@ namespace Editor
 		editorCamera.getFrustum().setProjectionMatrix(
 			glm::perspective(glm::radians(45.0f), 650.0f / 400.0f, 0.1f, 100.0f));
 
-		editor->getEventSystem().registerListener<Events::CameraFocus>(focusCamera);
+		focusCameraListener = editor->getEventSystem().registerListener<Events::CameraFocus>(focusCamera);
 	}
 
     SceneWindow::~SceneWindow()
     {
-		editor->getEventSystem().unregisterListener<Events::CameraFocus>(focusCamera);
+		editor->getEventSystem().unregisterListener(focusCameraListener);
     }
 
     void SceneWindow::draw(const EditorContext& context)
@@ -26,6 +26,7 @@ namespace Editor
 		void drawWindow(const EditorContext& context);
 		void cameraControls(double scrollYOffset, float deltaTime);
 
+		ListenerHandle focusCameraListener;
 		EventListener focusCamera = [this](const Event& event)
 			{
 				const Events::CameraFocus& cameraFocusEvent = static_cast<const Events::CameraFocus&>(event);
@@ -43,17 +43,9 @@ namespace Editor::Utils
 
 	void setUniqueName(int id, Scene& scene, std::string name)
 	{
-		std::string* objName;
+		const Scene& constScene = scene;
+		std::string baseName = !name.empty() ? name : constScene.getComponent<ObjectInfoComponent>(id).name;
 
-		bool newName = !name.empty();
-		if (newName)
-			objName = &name;
-		else
-			objName = &scene.getComponent<ObjectInfoComponent>(id).name;
-
-
-
-		std::string baseName = *objName;
 		auto leftParenthesisPos = baseName.rfind(" (");
 		auto rightParenthesisPos = baseName.rfind(')');
 		if (leftParenthesisPos != std::string::npos && rightParenthesisPos != std::string::npos)
@@ -68,12 +60,12 @@ namespace Editor::Utils
 
 		std::unordered_set<int> indices;
 
-		auto& parentTransform = scene.getComponent<Transform>(scene.getComponent<Transform>(id).parent);
-		for (auto& child : parentTransform.children)
+		auto& parentInfo = constScene.getComponent<TransformInfoComponent>(constScene.getComponent<Transform>(id).parent);
+		for (auto& child : parentInfo.children)
 		{
 			if (child == id) continue;
 
-			auto& childName = scene.getComponent<ObjectInfoComponent>(child).name;
+			auto& childName = constScene.getComponent<ObjectInfoComponent>(child).name;
 			if (childName.find(baseName) == 0)
 			{
 				if (childName.length() == baseName.length())
@@ -103,16 +95,11 @@ namespace Editor::Utils
 
 		if (lowestAvailableIndex > 0)
 		{
-			*objName = baseName + " (" + std::to_string(lowestAvailableIndex) + ")";
+			scene.setEntityName(id, baseName + " (" + std::to_string(lowestAvailableIndex) + ")");
 		}
 		else
 		{
-			*objName = baseName;
-		}
-
-		if (newName)
-		{
-			scene.getComponent<ObjectInfoComponent>(id).name = *objName;
+			scene.setEntityName(id, baseName);
 		}
 	}
 
@@ -0,0 +1,169 @@
+#include "JobSystem.h"
+
+#include <algorithm>
+
+static thread_local uint32_t threadQueueIndex = 0;
+
+
+JobSystem::JobSystem()
+{
+	uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+	startWorkers(hardwareThreads - 1);
+}
+
+JobSystem::~JobSystem()
+{
+	stopWorkers();
+}
+
+void JobSystem::setThreadCount(uint32_t threadCount)
+{
+	stopWorkers();
+	startWorkers(std::max(1u, threadCount) - 1);
+}
+
+void JobSystem::startWorkers(uint32_t workerCount)
+{
+	stopping = false;
+	queues.clear();
+	for (uint32_t i = 0; i <= workerCount; i++)
+	{
+		queues.push_back(std::make_unique<WorkQueue>());
+	}
+	for (uint32_t i = 1; i <= workerCount; i++)
+	{
+		workers.emplace_back(&JobSystem::workerLoop, this, i);
+	}
+}
+
+void JobSystem::stopWorkers()
+{
+	{
+		std::lock_guard lock(wakeMutex);
+		stopping = true;
+	}
+	wakeCondition.notify_all();
+	for (auto& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+void JobSystem::run(Job job, JobCounter& counter)
+{
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+	push(std::move(job), &counter);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, Job job, JobCounter& counter)
+{
+	counter.pending.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard lock(dependency.continuationsMutex);
+		if (!dependency.isDone())
+		{
+			dependency.continuations.emplace_back(std::move(job), &counter);
+			return;
+		}
+	}
+	push(std::move(job), &counter);
+}
+
+void JobSystem::wait(JobCounter& counter)
+{
+	while (!counter.isDone())
+	{
+		if (!tryRunOne())
+		{
+			std::this_thread::yield();
+		}
+	}
+	// wątek kończący ostatnie zadanie może jeszcze trzymać mutex licznika - po tym licznik można zniszczyć
+	std::lock_guard lock(counter.continuationsMutex);
+}
+
+void JobSystem::push(Job job, JobCounter* counter)
+{
+	uint32_t index = threadQueueIndex < queues.size() ? threadQueueIndex : 0;
+	{
+		std::lock_guard lock(queues[index]->mutex);
+		queues[index]->jobs.emplace_back(std::move(job), counter);
+	}
+	queuedJobs.fetch_add(1, std::memory_order_release);
+	{
+		// bez tego wątek sprawdzający warunek w workerLoop mógłby przegapić powiadomienie
+		std::lock_guard lock(wakeMutex);
+	}
+	wakeCondition.notify_one();
+}
+
+bool JobSystem::tryRunOne()
+{
+	std::pair<Job, JobCounter*> entry;
+	bool found = false;
+
+	uint32_t own = threadQueueIndex < queues.size() ? threadQueueIndex : 0;
+	{
+		// własna kolejka od końca - ostatnio dodane zadania mają jeszcze dane w cache
+		auto& queue = *queues[own];
+		std::lock_guard lock(queue.mutex);
+		if (!queue.jobs.empty())
+		{
+			entry = std::move(queue.jobs.back());
+			queue.jobs.pop_back();
+			found = true;
+		}
+	}
+
+	for (uint32_t offset = 1; !found && offset < queues.size(); offset++)
+	{
+		auto& victim = *queues[(own + offset) % queues.size()];
+		std::lock_guard lock(victim.mutex);
+		if (!victim.jobs.empty())
+		{
+			entry = std::move(victim.jobs.front());
+			victim.jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+		return false;
+
+	queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	entry.first();
+	finish(entry.second);
+	return true;
+}
+
+void JobSystem::finish(JobCounter* counter)
+{
+	std::vector<std::pair<Job, JobCounter*>> continuations;
+	{
+		// po zejściu do zera licznik może zostać zniszczony przez czekającego - nie dotykamy go po unlock
+		std::lock_guard lock(counter->continuationsMutex);
+		if (counter->pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+		continuations.swap(counter->continuations);
+	}
+	for (auto& [job, continuationCounter] : continuations)
+	{
+		push(std::move(job), continuationCounter);
+	}
+}
+
+void JobSystem::workerLoop(uint32_t index)
+{
+	threadQueueIndex = index;
+	while (true)
+	{
+		if (tryRunOne())
+			continue;
+
+		std::unique_lock lock(wakeMutex);
+		wakeCondition.wait(lock, [this]() { return stopping || queuedJobs.load(std::memory_order_acquire) > 0; });
+		if (stopping)
+			return;
+	}
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using Job = std::function<void()>;
+
+// Licznik grupy zadań - zwiększany przy zleceniu, zmniejszany po wykonaniu.
+// Zadania dodane przez JobSystem::runAfter startują dopiero, gdy licznik spadnie do zera.
+class JobCounter
+{
+public:
+	JobCounter() = default;
+	JobCounter(const JobCounter&) = delete;
+	JobCounter& operator=(const JobCounter&) = delete;
+
+	bool isDone() const { return pending.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> pending{ 0 };
+	std::mutex continuationsMutex;
+	std::vector<std::pair<Job, JobCounter*>> continuations;
+};
+
+// Pula wątków z kolejką na wątek: właściciel bierze zadania z końca swojej kolejki,
+// bezczynne wątki kradną z początku cudzych. Wątek czekający w wait() też wykonuje zadania.
+class JobSystem
+{
+public:
+	JobSystem(const JobSystem&) = delete;
+	JobSystem& operator=(const JobSystem&) = delete;
+	~JobSystem();
+
+	static JobSystem& GetInstance()
+	{
+		static JobSystem instance;
+		return instance;
+	}
+
+	// liczba wątków wykonujących zadania, łącznie z wątkiem wołającym wait()
+	uint32_t getThreadCount() const { return static_cast<uint32_t>(queues.size()); }
+
+	// zmiana liczby wątków roboczych (np. do pomiarów skalowania); nie wolno wołać w trakcie zadań
+	void setThreadCount(uint32_t threadCount);
+
+	void run(Job job, JobCounter& counter);
+	// job trafia do kolejki dopiero po zakończeniu wszystkich zadań z dependency
+	void runAfter(JobCounter& dependency, Job job, JobCounter& counter);
+	void wait(JobCounter& counter);
+	// wykonuje jedno oczekujące zadanie na wątku wołającym, false jeśli kolejki są puste
+	bool tryRunOne();
+
+	// func(begin, end) dla kolejnych przedziałów [0, count), wraca po wykonaniu całości
+	template<typename Func>
+	void parallelFor(uint32_t count, uint32_t minBatchSize, Func&& func)
+	{
+		if (count == 0)
+			return;
+
+		uint32_t batchSize = std::max(minBatchSize, (count + getThreadCount() * 4 - 1) / (getThreadCount() * 4));
+		if (batchSize == 0 || batchSize >= count || getThreadCount() == 1)
+		{
+			func(0u, count);
+			return;
+		}
+
+		JobCounter counter;
+		for (uint32_t begin = 0; begin < count; begin += batchSize)
+		{
+			uint32_t end = std::min(begin + batchSize, count);
+			run([&func, begin, end]() { func(begin, end); }, counter);
+		}
+		wait(counter);
+	}
+
+private:
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<std::pair<Job, JobCounter*>> jobs;
+	};
+
+	JobSystem();
+
+	void startWorkers(uint32_t workerCount);
+	void stopWorkers();
+	void workerLoop(uint32_t index);
+
+	void push(Job job, JobCounter* counter);
+	void finish(JobCounter* counter);
+
+	// indeks 0 - wątek główny (i każdy spoza puli), 1..N - wątki robocze
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+	std::vector<std::thread> workers;
+
+	std::atomic<uint32_t> queuedJobs{ 0 };
+	std::atomic<bool> stopping{ false };
+	std::mutex wakeMutex;
+	std::condition_variable wakeCondition;
+};
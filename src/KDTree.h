@@ -6,7 +6,7 @@
 #define PBL_KDTREE_H
 #include "ECS/BoundingVolumes.h"
 #include "ECS/ComponentStorage.h"
-#include "Ecs/RenderingSystem.h"
+#include "ECS/RenderingSystem.h"
 
 static bool isOnOrForwardPlane(const BoundingBox& aabb, const Plane& plane)
 {
@@ -50,9 +50,10 @@ struct BVHNode {
     BoundingBox box;
     std::unique_ptr<BVHNode> left;
     std::unique_ptr<BVHNode> right;
-    ModelComponent* object = nullptr;
+    // ID encji zamiast wskaźnika - storage może przenieść komponenty przy powiększaniu
+    EntityID entity = (EntityID)-1;
 
-    bool isLeaf() const { return object != nullptr; }
+    bool isLeaf() const { return entity != (EntityID)-1; }
 };
 
 inline std::unique_ptr<BVHNode> buildBVH(std::vector<ModelComponent*>& objects, int depth = 0) {
@@ -67,7 +68,7 @@ inline std::unique_ptr<BVHNode> buildBVH(std::vector<ModelComponent*>& objects,
     //     node->box = node->box.merge(globalBox);
     // }
     if (objects.size() == 1) {
-        node->object = objects[0];
+        node->entity = objects[0]->id;
         node->box = objects[0]->model->boundingBox.getGlobalBox(*objects[0]->transform);
         return node;
     }
@@ -106,9 +107,8 @@ inline void traverseBVHFrustum(const BVHNode* node, const FrustumPlanes& frustum
         return;
 
     if (node->isLeaf()) {
-        if (isOnFrustum(node->object->model->boundingBox, frustum, *node->object->transform)) {
-            visibleIds.push_back(node->object->id);
-        }
+        // liść trzyma globalne AABB statycznego obiektu, sprawdzone już wyżej
+        visibleIds.push_back(node->entity);
     } else {
         traverseBVHFrustum(node->left.get(), frustum, visibleIds);
         traverseBVHFrustum(node->right.get(), frustum, visibleIds);
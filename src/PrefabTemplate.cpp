@@ -0,0 +1,333 @@
+#include "PrefabTemplate.h"
+
+#include "Scene.h"
+#include "ECS/components/CameraController.h"
+
+
+// Referencje do innych encji - przy kompilacji zamieniane na indeksy lokalne, przy instancjonowaniu na nowe ID.
+// Typy bez referencji (poza własnym id) korzystają z pustej wersji.
+template<typename T, typename Map>
+static void remapEntities(T&, const Map&) {}
+
+template<typename Map>
+static void remapEntities(FlyAIComponent& c, const Map& map)
+{
+    c.idButter = map(c.idButter);
+    c.idBread = map(c.idBread);
+}
+
+template<typename Map>
+static void remapEntities(ElevatorComponent& c, const Map& map)
+{
+    c.buttonEntity = map(c.buttonEntity);
+}
+
+template<typename Map>
+static void remapEntities(ButtonComponent& c, const Map& map)
+{
+    c.elevatorEntity = map(c.elevatorEntity);
+}
+
+template<typename Map>
+static void remapEntities(CameraController& c, const Map& map)
+{
+    c.targetID = map(c.targetID);
+}
+
+template<typename Map>
+static void remapEntities(SplitScreenController& c, const Map& map)
+{
+    c.target1 = map(c.target1);
+    c.camera1 = map(c.camera1);
+    c.target2 = map(c.target2);
+    c.camera2 = map(c.camera2);
+}
+
+// Kopia komponentu dla nowej instancji
+template<typename T>
+static T makeInstance(const T& component)
+{
+    return component;
+}
+
+// ColliderComponent trzyma kształt przez shared_ptr - każda instancja dostaje własny
+static ColliderComponent makeInstance(const ColliderComponent& component)
+{
+    const ColliderShape* shape = component.GetColliderShape();
+    if (!shape)
+        return component;
+
+    ColliderComponent instance(shape->getType(), component.isStatic);
+    instance.id = component.id;
+    switch (shape->getType())
+    {
+    case ColliderType::BOX:
+        *static_cast<BoxCollider*>(instance.GetColliderShape()) = *static_cast<const BoxCollider*>(shape);
+        break;
+    case ColliderType::SPHERE:
+        *static_cast<SphereCollider*>(instance.GetColliderShape()) = *static_cast<const SphereCollider*>(shape);
+        break;
+    }
+    return instance;
+}
+
+// Przywrócenie wartości w istniejącym komponencie
+template<typename T>
+static void resetInstance(T& instance, const T& component)
+{
+    instance = component;
+}
+
+// wskaźnik na Transform ustawia RenderingSystem dla tej encji - zostaje
+static void resetInstance(ModelComponent& instance, const ModelComponent& component)
+{
+    Transform* transform = instance.transform;
+    instance = component;
+    instance.transform = transform;
+}
+
+// kształt kopiowany w miejscu - bez nowej alokacji, o ile typ kształtu się nie zmienił
+static void resetInstance(ColliderComponent& instance, const ColliderComponent& component)
+{
+    ColliderShape* target = instance.GetColliderShape();
+    const ColliderShape* shape = component.GetColliderShape();
+    if (!target || !shape || target->getType() != shape->getType())
+    {
+        instance = makeInstance(component);
+        return;
+    }
+
+    instance.isStatic = component.isStatic;
+    switch (shape->getType())
+    {
+    case ColliderType::BOX:
+        *static_cast<BoxCollider*>(target) = *static_cast<const BoxCollider*>(shape);
+        break;
+    case ColliderType::SPHERE:
+        *static_cast<SphereCollider*>(target) = *static_cast<const SphereCollider*>(shape);
+        break;
+    }
+}
+
+
+struct PrefabTemplate::IComponentBlock {
+    virtual ~IComponentBlock() = default;
+    virtual void instantiate(Scene& scene, const std::vector<EntityID>& instantiated) const = 0;
+    virtual void reset(Scene& scene, const std::vector<EntityID>& instance) const = 0;
+};
+
+template<typename T>
+struct PrefabTemplate::ComponentBlock : IComponentBlock {
+    // owners[i] - lokalny indeks encji, do której należy values[i]
+    std::vector<uint32_t> owners;
+    std::vector<T> values;
+
+    void instantiate(Scene& scene, const std::vector<EntityID>& instantiated) const override
+    {
+        auto toInstance = [&](EntityID local) {
+            return local == (EntityID)-1 ? local : instantiated[local];
+        };
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            T component = makeInstance(values[i]);
+            remapEntities(component, toInstance);
+            component.id = instantiated[owners[i]];
+            scene.addComponent<T>(component.id, component);
+        }
+    }
+
+    void reset(Scene& scene, const std::vector<EntityID>& instance) const override
+    {
+        auto toInstance = [&](EntityID local) {
+            return local == (EntityID)-1 ? local : instance[local];
+        };
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            EntityID id = instance[owners[i]];
+            if (!scene.hasComponent<T>(id))
+            {
+                T component = makeInstance(values[i]);
+                remapEntities(component, toInstance);
+                component.id = id;
+                scene.addComponent<T>(id, component);
+                continue;
+            }
+
+            T& component = scene.getComponent<T>(id);
+            resetInstance(component, values[i]);
+            remapEntities(component, toInstance);
+            component.id = id;
+        }
+    }
+};
+
+
+PrefabTemplate::PrefabTemplate() = default;
+PrefabTemplate::~PrefabTemplate() = default;
+PrefabTemplate::PrefabTemplate(PrefabTemplate&&) noexcept = default;
+PrefabTemplate& PrefabTemplate::operator=(PrefabTemplate&&) noexcept = default;
+
+template<typename T>
+void PrefabTemplate::compileComponents(const Scene& staging, const std::vector<EntityID>& order,
+    const std::unordered_map<EntityID, uint32_t>& localIndex)
+{
+    auto storage = staging.getStorage<T>();
+    if (!storage)
+        return;
+
+    auto toLocal = [&](EntityID id) {
+        auto it = localIndex.find(id);
+        return it != localIndex.end() ? (EntityID)it->second : (EntityID)-1;
+    };
+
+    auto block = std::make_unique<ComponentBlock<T>>();
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        if (!storage->has(order[i]))
+            continue;
+
+        T component = storage->get(order[i]);
+        remapEntities(component, toLocal);
+        block->owners.push_back(i);
+        block->values.push_back(std::move(component));
+    }
+
+    if (!block->values.empty())
+        components.push_back(std::move(block));
+}
+
+PrefabTemplate PrefabTemplate::compile(const nlohmann::json& prefabJson, const Serialization::GlobalDeserializationContext& context)
+{
+    PrefabTemplate result;
+
+    // JSON przechodzi przez zwykłą deserializację raz, do pomocniczej sceny
+    Scene staging(nullptr);
+    EntityID stagingRoot = staging.getSceneRootEntity();
+    std::vector<EntityID> deserialized = Serialization::deserializeObjects(prefabJson, staging, stagingRoot,
+        { context.shaders, context.models, false });
+
+    // kolejność pre-order - rodzic zawsze przed dziećmi, dzięki temu instancja buduje graf jednym przebiegiem
+    std::vector<EntityID> order;
+    std::unordered_map<EntityID, uint32_t> localIndex;
+    order.reserve(deserialized.size());
+
+    auto visit = [&](auto& self, EntityID id) -> void {
+        localIndex[id] = static_cast<uint32_t>(order.size());
+        order.push_back(id);
+        for (EntityID child : staging.getComponent<TransformInfoComponent>(id).children)
+        {
+            self(self, child);
+        }
+    };
+    for (EntityID id : deserialized)
+    {
+        if (staging.getComponent<Transform>(id).parent == stagingRoot)
+            visit(visit, id);
+    }
+
+    result.entities.reserve(order.size());
+    for (EntityID id : order)
+    {
+        const auto& info = staging.getComponent<ObjectInfoComponent>(id);
+        const auto& transform = staging.getComponent<Transform>(id);
+        auto parent = localIndex.find(transform.parent);
+
+        result.entities.push_back({
+            .name = info.name,
+            .tag = info.tag,
+            .transform = transform,
+            .eulerRotation = staging.getComponent<TransformInfoComponent>(id).eulerRotation,
+            .parent = parent != localIndex.end() ? parent->second : NO_PARENT
+        });
+    }
+
+    // ta sama lista typów co w Serialization::deserializeObjects
+    result.compileComponents<ModelComponent>(staging, order, localIndex);
+    result.compileComponents<ImageComponent>(staging, order, localIndex);
+    result.compileComponents<TextComponent>(staging, order, localIndex);
+    result.compileComponents<ColliderComponent>(staging, order, localIndex);
+
+    result.compileComponents<CameraComponent>(staging, order, localIndex);
+
+    result.compileComponents<PointLightComponent>(staging, order, localIndex);
+    result.compileComponents<DirectionalLightComponent>(staging, order, localIndex);
+
+    result.compileComponents<FlyAIComponent>(staging, order, localIndex);
+
+    result.compileComponents<VelocityComponent>(staging, order, localIndex);
+    result.compileComponents<HeatComponent>(staging, order, localIndex);
+    result.compileComponents<RegenComponent>(staging, order, localIndex);
+    result.compileComponents<FreezeComponent>(staging, order, localIndex);
+    result.compileComponents<ButterHealthComponent>(staging, order, localIndex);
+    result.compileComponents<ElevatorComponent>(staging, order, localIndex);
+    result.compileComponents<ButtonComponent>(staging, order, localIndex);
+
+    result.compileComponents<BreadController>(staging, order, localIndex);
+    result.compileComponents<ButterController>(staging, order, localIndex);
+
+    result.compileComponents<CameraController>(staging, order, localIndex);
+    result.compileComponents<SplitScreenController>(staging, order, localIndex);
+
+    return result;
+}
+
+std::vector<EntityID> PrefabTemplate::instantiate(Scene& scene, EntityID parent) const
+{
+    std::vector<EntityID> instantiated;
+    instantiated.reserve(entities.size());
+
+    for (const auto& entity : entities)
+    {
+        EntityID id = scene.createEntity(entity.parent == NO_PARENT ? parent : instantiated[entity.parent]);
+
+        auto& transform = scene.getComponent<Transform>(id);
+        EntityID transformParent = transform.parent;
+        transform = entity.transform;
+        transform.parent = transformParent;
+        transform.id = id;
+        scene.getTransformSystem().markDirty(id);
+        scene.getComponent<TransformInfoComponent>(id).eulerRotation = entity.eulerRotation;
+
+        scene.setEntityName(id, entity.name);
+        scene.setEntityTag(id, entity.tag);
+
+        instantiated.push_back(id);
+    }
+
+    for (const auto& block : components)
+    {
+        block->instantiate(scene, instantiated);
+    }
+
+    return instantiated;
+}
+
+void PrefabTemplate::reset(Scene& scene, const std::vector<EntityID>& instance) const
+{
+    assert(instance.size() == entities.size() && "PrefabTemplate: instance does not match the prefab");
+
+    for (size_t i = 0; i < entities.size(); i++)
+    {
+        const auto& entity = entities[i];
+        EntityID id = instance[i];
+
+        auto& transform = scene.getComponent<Transform>(id);
+        EntityID transformParent = transform.parent;
+        transform = entity.transform;
+        transform.parent = transformParent;
+        transform.id = id;
+        scene.getTransformSystem().markDirty(id);
+        scene.getComponent<TransformInfoComponent>(id).eulerRotation = entity.eulerRotation;
+
+        // bez zmian, jeśli nazwa/tag są takie same - bez alokacji i przebudowy indeksów
+        scene.setEntityName(id, entity.name);
+        scene.setEntityTag(id, entity.tag);
+    }
+
+    for (const auto& block : components)
+    {
+        block->reset(scene, instance);
+    }
+}
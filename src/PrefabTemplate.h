@@ -0,0 +1,56 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "ECS/Components.h"
+#include "Serialization.h"
+
+class Scene;
+
+// Prefab przetworzony raz przy wczytaniu: komponenty już zdeserializowane do typowanych tablic,
+// relacje (rodzic, referencje do encji) zapisane jako indeksy lokalne w prefabie.
+// Instancjonowanie to tylko tworzenie encji i wstawianie kopii komponentów - bez JSON-a i map uuid.
+class PrefabTemplate {
+public:
+    PrefabTemplate();
+    ~PrefabTemplate();
+    PrefabTemplate(PrefabTemplate&&) noexcept;
+    PrefabTemplate& operator=(PrefabTemplate&&) noexcept;
+
+    static PrefabTemplate compile(const nlohmann::json& prefabJson, const Serialization::GlobalDeserializationContext& context);
+
+    // zwraca nowe encje, pierwsza to korzeń prefabu (jak Serialization::deserializeObjects)
+    std::vector<EntityID> instantiate(Scene& scene, EntityID parent) const;
+
+    // przywraca wartości z prefabu w istniejącej instancji (encje w kolejności z instantiate()),
+    // bez tworzenia encji i przesuwania komponentów - używane przez EntityPool
+    void reset(Scene& scene, const std::vector<EntityID>& instance) const;
+
+private:
+    static constexpr uint32_t NO_PARENT = (uint32_t)-1;
+
+    struct EntityTemplate {
+        std::string name;
+        std::string tag;
+        Transform transform;
+        glm::vec3 eulerRotation;
+        // indeks w entities (zawsze mniejszy od własnego) albo NO_PARENT - dziecko encji podanej w instantiate()
+        uint32_t parent;
+    };
+
+    struct IComponentBlock;
+    template<typename T>
+    struct ComponentBlock;
+
+    template<typename T>
+    void compileComponents(const Scene& staging, const std::vector<EntityID>& order,
+        const std::unordered_map<EntityID, uint32_t>& localIndex);
+
+    std::vector<EntityTemplate> entities;
+    std::vector<std::unique_ptr<IComponentBlock>> components;
+};
@@ -4,7 +4,8 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-static std::mt19937 rng(std::random_device{}());
+// osobny generator na wątek - systemy mogą losować równolegle
+static thread_local std::mt19937 rng(std::random_device{}());
 
 int Random::getInt(int minInclusive, int maxExclusive) {
 	std::uniform_int_distribution<int> dist(minInclusive, maxExclusive - 1);
@@ -0,0 +1,260 @@
+#include "Renderer.h"
+
+#include "stb_image.h"
+#include "Random.h"
+
+
+static std::array<glm::vec3, 16> generateSSAONoise() {
+	std::array<glm::vec3, 16> noise;
+	for (int i = 0; i < 16; ++i) {
+		glm::vec3 v = {
+			Random::getFloat(-1.0f, 1.0f),
+			Random::getFloat(-1.0f, 1.0f),
+			0.0f
+		};
+		noise[i] = glm::normalize(v);
+	}
+
+	return noise;
+}
+
+
+Renderer::Renderer()
+{
+	glBindTexture(GL_TEXTURE_2D, shadowFramebuffer.GetDepthTexture());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+	GLfloat borderColor[] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, borderColor);
+
+	ssaoNoise = generateSSAONoise();
+
+	glGenTextures(1, &ssaoNoiseTexture);
+	glBindTexture(GL_TEXTURE_2D, ssaoNoiseTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB16F, 4, 4, 0, GL_RGB, GL_FLOAT, ssaoNoise.data());
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+
+	float vertices[] = {
+		-1.0f, -1.0f, 0.0f, 0.0f,
+		 1.0f, -1.0f, 1.0f, 0.0f,
+		 1.0f,  1.0f, 1.0f, 1.0f,
+		-1.0f,  1.0f, 0.0f, 1.0f
+	};
+
+	unsigned int indices[] = {
+		0, 1, 2,
+		0, 2, 3
+	};
+
+	glGenVertexArrays(1, &hudVAO);
+	glGenBuffers(1, &hudVBO);
+	glGenBuffers(1, &hudEBO);
+
+	glBindVertexArray(hudVAO);
+
+	glBindBuffer(GL_ARRAY_BUFFER, hudVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, hudEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)(2 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+}
+
+Renderer::~Renderer()
+{
+	glDeleteTextures(1, &ssaoNoiseTexture);
+	glDeleteVertexArrays(1, &hudVAO);
+	glDeleteBuffers(1, &hudVBO);
+	glDeleteBuffers(1, &hudEBO);
+	for (auto& [path, textureID] : textures) {
+		glDeleteTextures(1, &textureID);
+	}
+}
+
+void Renderer::resizeTargets(uint32_t width, uint32_t height)
+{
+	std::array targets = { &customFramebuffer, &auxiliaryFramebuffer1, &auxiliaryFramebuffer2,
+		&postProcessingFramebuffer1, &postProcessingFramebuffer2, &ssaoFramebuffer };
+	for (auto& target : targets) {
+		auto [targetWidth, targetHeight] = target->GetSizePair();
+		if (targetWidth != width || targetHeight != height) {
+			target->Resize(width, height);
+		}
+	}
+}
+
+GLuint Renderer::getTexture(const std::string& path) {
+	if (textures.find(path) != textures.end()) {
+		return textures[path];
+	}
+
+	int width, height, nrChannels;
+	unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, 0);
+	if (data) {
+		GLuint textureID;
+		glGenTextures(1, &textureID);
+		glBindTexture(GL_TEXTURE_2D, textureID);
+
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+		stbi_image_free(data);
+
+		textures[path] = textureID;
+		return textureID;
+	} else {
+		std::cerr << "Failed to load texture: " << path << std::endl;
+		return 0;
+	}
+}
+
+TextRenderer& Renderer::getTextRenderer() {
+	if (!initializedText) {
+		t1.init("../../res/fonts/sixtyfour.ttf");
+		initializedText = true;
+	}
+	return t1;
+}
+
+void Renderer::drawQuad() const {
+	glBindVertexArray(hudVAO);
+	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	glBindVertexArray(0);
+}
+
+void Renderer::sobelFilter(Shader* sobel, const CustomFramebuffer& in, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	sobel->use();
+	auto [width, height] = in.GetSizePair();
+	sobel->setInt("width", width);
+	sobel->setInt("height", height);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
+	sobel->setInt("textureSampler", 0);
+
+	drawQuad();
+}
+
+void Renderer::motionBlurFilter(Shader* blur, const CustomFramebuffer& in,
+	const CustomFramebuffer& inVel, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	blur->use();
+	auto [width, height] = in.GetSizePair();
+	blur->setInt("width", width);
+	blur->setInt("height", height);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, inVel.GetVelocityTexture());
+	blur->setInt("textureSampler", 0);
+	blur->setInt("velTextureSampler", 1);
+
+	drawQuad();
+}
+
+void Renderer::fxaaFilter(Shader* fxaa, const CustomFramebuffer& in,
+	const CustomFramebuffer& test, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	fxaa->use();
+	auto [width, height] = in.GetSizePair();
+	fxaa->setVec2("resolution", (float)width, (float)height);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
+	fxaa->setInt("textureSampler", 0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, test.GetColorTexture());
+	fxaa->setInt("testSampler", 1);
+
+	drawQuad();
+}
+
+void Renderer::shadowFxaaFilter(Shader* fxaa, const CustomFramebuffer& in, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	fxaa->use();
+	auto [width, height] = in.GetSizePair();
+	fxaa->setVec2("resolution", (float)width, (float)height);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetDepthTexture());
+	fxaa->setInt("shadowMap", 0);
+
+	drawQuad();
+}
+
+void Renderer::ssaoFilter(Shader* ssao, const CustomFramebuffer& gBuffer, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	ssao->use();
+	auto [width, height] = gBuffer.GetSizePair();
+	ssao->setInt("width", width);
+	ssao->setInt("height", height);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, gBuffer.GetNormalTexture());
+	ssao->setInt("normalTexture", 1);
+
+	glActiveTexture(GL_TEXTURE2);
+	glBindTexture(GL_TEXTURE_2D, ssaoNoiseTexture);
+	ssao->setInt("noiseTexture", 2);
+
+	glActiveTexture(GL_TEXTURE3);
+	glBindTexture(GL_TEXTURE_2D, gBuffer.GetDepthTexture());
+	ssao->setInt("depthTexture", 3);
+
+	drawQuad();
+}
+
+void Renderer::ssaoApplyFilter(Shader* ssaoApply, const CustomFramebuffer& in, const CustomFramebuffer& ssao, const Framebuffer& out) const
+{
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	ssaoApply->use();
+	auto [width, height] = in.GetSizePair();
+	ssaoApply->setInt("width", width);
+	ssaoApply->setInt("height", height);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
+	ssaoApply->setInt("colorTexture", 0);
+
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, ssao.GetColorTexture());
+	ssaoApply->setInt("ssaoTexture", 1);
+
+	drawQuad();
+}
+
+void Renderer::dynamicSplitScreen(Shader* dynamicSplitScreen, Camera& camera, const CustomFramebuffer& in,
+	CustomFramebuffer& in2, const Framebuffer& out) const {
+	out.Bind();
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	dynamicSplitScreen->use();
+
+	glm::vec2 viewportSize = glm::vec2(in.GetSizePair().first, in.GetSizePair().second);
+	dynamicSplitScreen->setVec2("viewport_size", viewportSize);
+
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, in.GetColorTexture());
+	dynamicSplitScreen->setInt("viewport1", 0);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, in2.GetColorTexture());
+	dynamicSplitScreen->setInt("viewport2", 1);
+
+	drawQuad();
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <glm/glm.hpp>
+
+#include "Camera.h"
+#include "Shader.h"
+#include "TextRenderer.h"
+#include "Framebuffer.h"
+
+// Zasoby GPU wspólne dla wszystkich scen: render targety, szum SSAO, quad pełnoekranowy, tekstury HUD.
+// Należy do Application i jest tworzony raz - kopia Scene (np. backup w edytorze) nie alokuje nic na GPU.
+class Renderer
+{
+public:
+	Renderer();
+	~Renderer();
+
+	Renderer(const Renderer&) = delete;
+	Renderer& operator=(const Renderer&) = delete;
+
+	// dopasowuje render targety pełnoekranowe do rozmiaru wyjścia
+	void resizeTargets(uint32_t width, uint32_t height);
+
+	GLuint getTexture(const std::string& path);
+	TextRenderer& getTextRenderer();
+	void drawQuad() const;
+
+	void sobelFilter(Shader* sobel, const CustomFramebuffer& in, const Framebuffer& out) const;
+	void motionBlurFilter(Shader* blur, const CustomFramebuffer& in,
+		const CustomFramebuffer& inVel, const Framebuffer& out) const;
+	void fxaaFilter(Shader* fxaa, const CustomFramebuffer& in, const CustomFramebuffer& test, const Framebuffer& out) const;
+	void shadowFxaaFilter(Shader* fxaa, const CustomFramebuffer& in, const Framebuffer& out) const;
+	void ssaoFilter(Shader* ssao, const CustomFramebuffer& gBuffer, const Framebuffer& out) const;
+	void ssaoApplyFilter(Shader* ssaoApply, const CustomFramebuffer& in, const CustomFramebuffer& ssao, const Framebuffer& out) const;
+	void dynamicSplitScreen(Shader* dynamicSplitScreen, Camera& camera, const CustomFramebuffer& in, CustomFramebuffer& in2, const Framebuffer& out) const;
+
+	CustomFramebuffer customFramebuffer{ FramebufferConfig{ 1920, 1080,
+		{ AttachmentType::COLOR, AttachmentType::DEPTH, AttachmentType::POSITION,
+		AttachmentType::NORMAL, AttachmentType::VELOCITY } } };
+
+	CustomFramebuffer auxiliaryFramebuffer1{ FramebufferConfig{ 1920, 1080, { AttachmentType::COLOR } } };
+	CustomFramebuffer auxiliaryFramebuffer2{ FramebufferConfig{ 1920, 1080, { AttachmentType::COLOR } } };
+	CustomFramebuffer postProcessingFramebuffer1{ FramebufferConfig{ 1920, 1080, { AttachmentType::COLOR } } };
+	CustomFramebuffer postProcessingFramebuffer2{ FramebufferConfig{ 1920, 1080, { AttachmentType::COLOR } } };
+	CustomFramebuffer ssaoFramebuffer{ FramebufferConfig{ 1920, 1080, { AttachmentType::COLOR }, GL_RED, GL_FLOAT } };
+
+	const uint32_t shadowMapWidth = 2048;
+	const uint32_t shadowMapHeight = 2048;
+	CustomFramebuffer shadowFramebuffer = CustomFramebuffer(FramebufferConfig{ shadowMapWidth, shadowMapHeight, { AttachmentType::DEPTH } });
+	CustomFramebuffer shadowPostFramebuffer = CustomFramebuffer(FramebufferConfig{ shadowMapWidth, shadowMapHeight, { AttachmentType::COLOR } });
+
+private:
+	std::map<std::string, GLuint> textures;
+
+	GLuint hudVAO, hudVBO, hudEBO;
+	TextRenderer t1;
+	bool initializedText = false;
+
+	std::array<glm::vec3, 16> ssaoNoise;
+	GLuint ssaoNoiseTexture;
+};
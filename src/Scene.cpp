@@ -1,55 +1,151 @@
 #include "Scene.h"
 #include "Application.h"
 
+#include <algorithm>
+
 Scene::Scene(Application* app) : app(app)
 {
     entityManager = EntityManager();
     sceneGraphRoot = entityManager.createEntity();
-    auto& t = addComponent<Transform>(sceneGraphRoot, Transform{});
+    addComponent<Transform>(sceneGraphRoot, Transform{});
+    addComponent<TransformInfoComponent>(sceneGraphRoot);
 
-    auto& info = addComponent<ObjectInfoComponent>(sceneGraphRoot);
+    ObjectInfoComponent info;
     info.uuid = uuid::generate();
+    addComponent<ObjectInfoComponent>(sceneGraphRoot, info);
 }
 
 Scene::Scene(const Scene& other)
-    : entityManager(other.entityManager), app(other.app)
+    : app(other.app), storages(other.storages), entityManager(other.entityManager),
+    entityPool(this, other.entityPool), sceneGraphRoot(other.sceneGraphRoot), changeTick(other.changeTick),
+    uuidIndex(other.uuidIndex), tagIndex(other.tagIndex), nameIndex(other.nameIndex)
 {
-    for (const auto& [type, storage] : other.storages) 
-    {
-        storages[type] = std::unique_ptr<IComponentStorage>(storage->clone());
-    }
 }
 
+void Scene::restoreFrom(const Scene& backup)
+{
+    storages = backup.storages;
+    entityManager = backup.entityManager;
+    entityPool = EntityPool(this, backup.entityPool);
+    sceneGraphRoot = backup.sceneGraphRoot;
+    changeTick = backup.changeTick;
+    uuidIndex = backup.uuidIndex;
+    tagIndex = backup.tagIndex;
+    nameIndex = backup.nameIndex;
+
+    // stan pochodny od encji liczony od nowa, jak w kopii sceny
+    transformSystem = TransformSystem(this);
+    renderingSystem = RenderingSystem(this);
+    flyAISystem = FlyAISystem(this);
+    commandBuffer = CommandBuffer(this);
+    collisionSystem.ClearCollisions();
+    eventSystem.clearQueued();
+}
 
 EntityID Scene::createEntity(EntityID parent) {
     EntityID id = entityManager.createEntity();
-    auto& t = addComponent<Transform>(id, Transform{});
-    auto& info = addComponent<ObjectInfoComponent>(id);
-
-    if (parent < 0 || parent > MAX_ENTITIES) parent = sceneGraphRoot;
-    auto& parentTransform = getComponent<Transform>(parent);
-    parentTransform.children.push_back(id);
+    if (!entityManager.isAlive(parent)) parent = sceneGraphRoot;
 
+    Transform t;
     t.parent = parent;
+    addComponent<Transform>(id, t);
+    addComponent<TransformInfoComponent>(id);
+    getComponent<TransformInfoComponent>(parent).children.push_back(id);
+    transformSystem.onEntityCreated(id);
+
+    ObjectInfoComponent info;
     info.uuid = uuid::generate();
+    addComponent<ObjectInfoComponent>(id, info);
     return id;
 }
 
 void Scene::destroyEntity(EntityID id) {
-    if (hasComponent<Transform>(id)) {
-        auto& transform = getComponent<Transform>(id);
+    destroyEntities(std::span<const EntityID>(&id, 1));
+}
 
-        for (const auto& child : transform.children) {
-            destroyEntity(child);
-        }
-        transformSystem.removeChild(transform.parent, id);
-        for (auto& component : storages) {
-            if (component.second->has(id)) {
-                component.second->remove(id);
+void Scene::destroyEntities(std::span<const EntityID> ids) {
+    const Scene& constThis = *this;
+    auto transforms = constThis.getStorage<Transform>();
+    auto transformInfos = constThis.getStorage<TransformInfoComponent>();
+
+    // bufory z poprzednich wywołań - po rozgrzaniu usuwanie nie alokuje
+    auto& [roots, rootVisited, doomed, sortedDoomed, stack, survivingParents] = destroyScratch;
+    roots.assign(ids.begin(), ids.end());
+    std::sort(roots.begin(), roots.end());
+    roots.erase(std::unique(roots.begin(), roots.end()), roots.end());
+    rootVisited.assign(roots.size(), 0);
+    auto isRoot = [&](EntityID id) { return std::binary_search(roots.begin(), roots.end(), id); };
+
+    // pełny zbiór: podane encje i wszystkie ich dzieci. Dziecko będące też korzeniem jest pomijane -
+    // jego poddrzewo zbierze jego własne przejście, więc każda encja trafia do zbioru raz.
+    doomed.clear();
+    for (EntityID root : ids) {
+        if (!entityManager.isAlive(root))
+            continue;
+        // powtórzony korzeń - tylko pierwsze wystąpienie
+        size_t rootPosition = std::lower_bound(roots.begin(), roots.end(), root) - roots.begin();
+        if (rootVisited[rootPosition])
+            continue;
+        rootVisited[rootPosition] = 1;
+        stack.push_back(root);
+        while (!stack.empty()) {
+            EntityID id = stack.back();
+            stack.pop_back();
+            doomed.push_back(id);
+            if (!transformInfos || !transformInfos->has(id))
+                continue;
+            for (EntityID child : transformInfos->get(id).children) {
+                if (!isRoot(child))
+                    stack.push_back(child);
             }
         }
     }
-    entityManager.destroyEntity(id);
+    if (doomed.empty()) return;
+
+    // przynależność do zbioru - wyszukiwanie binarne, pamięć proporcjonalna do liczby usuwanych encji
+    sortedDoomed.assign(doomed.begin(), doomed.end());
+    std::sort(sortedDoomed.begin(), sortedDoomed.end());
+    auto isDoomed = [&](EntityID id) { return std::binary_search(sortedDoomed.begin(), sortedDoomed.end(), id); };
+
+    // rodzic spoza zbioru może być tylko rodzicem korzenia - każdy dostaje jedno przefiltrowanie listy dzieci
+    survivingParents.clear();
+    if (transforms) {
+        for (EntityID root : roots) {
+            if (!isDoomed(root) || !transforms->has(root)) continue;
+            EntityID parent = transforms->get(root).parent;
+            if (parent != (EntityID)-1 && !isDoomed(parent))
+                survivingParents.push_back(parent);
+        }
+    }
+    std::sort(survivingParents.begin(), survivingParents.end());
+    survivingParents.erase(std::unique(survivingParents.begin(), survivingParents.end()), survivingParents.end());
+    for (EntityID parent : survivingParents) {
+        if (!constThis.hasComponent<TransformInfoComponent>(parent)) continue;
+        std::erase_if(getComponent<TransformInfoComponent>(parent).children,
+            [&](EntityID child) { return isDoomed(child); });
+    }
+
+    if (auto infos = constThis.getStorage<ObjectInfoComponent>()) {
+        for (EntityID id : doomed) {
+            if (infos->has(id)) unindexObjectInfo(infos->get(id));
+        }
+    }
+
+    for (auto& storage : storages) {
+        if (!storage) continue;
+        // współdzielony storage bez żadnej z encji nie jest kopiowany
+        if (storage.use_count() > 1 &&
+            std::none_of(doomed.begin(), doomed.end(), [&](EntityID id) { return storage->has(id); }))
+            continue;
+        detachStorage(storage);
+        storage->removeMany(doomed);
+    }
+
+    entityPool.onEntitiesDestroyed(doomed);
+
+    for (EntityID id : doomed) {
+        entityManager.destroyEntity(id);
+    }
 }
 
 bool Scene::hasEntity(EntityID id) const {
@@ -64,3 +160,105 @@ std::vector<EntityID> Scene::instantiatePrefab(const std::string& prefabName, En
 {
 	return app->instantiatePrefab(prefabName, *this, parent);
 }
+
+const PrefabTemplate* Scene::findPrefab(const std::string& prefabName) const
+{
+	return app ? app->findPrefab(prefabName) : nullptr;
+}
+
+
+static void insertIntoIndex(std::vector<EntityID>& entities, EntityID id)
+{
+    if (std::find(entities.begin(), entities.end(), id) == entities.end())
+        entities.push_back(id);
+}
+
+template<typename Index>
+static void eraseFromIndex(Index& index, std::string_view key, EntityID id)
+{
+    if (key.empty()) return;
+    auto it = index.find(key);
+    if (it == index.end()) return;
+
+    auto& entities = it->second;
+    auto pos = std::find(entities.begin(), entities.end(), id);
+    if (pos != entities.end()) {
+        *pos = entities.back();
+        entities.pop_back();
+    }
+    if (entities.empty()) index.erase(it);
+}
+
+void Scene::indexObjectInfo(const ObjectInfoComponent& info)
+{
+    if (!info.uuid.empty()) uuidIndex[info.uuid] = info.id;
+    if (!info.tag.empty()) insertIntoIndex(tagIndex[info.tag], info.id);
+    if (!info.name.empty()) insertIntoIndex(nameIndex[info.name], info.id);
+}
+
+void Scene::unindexObjectInfo(const ObjectInfoComponent& info)
+{
+    if (auto it = uuidIndex.find(info.uuid); it != uuidIndex.end() && it->second == info.id) {
+        uuidIndex.erase(it);
+    }
+    eraseFromIndex(tagIndex, info.tag, info.id);
+    eraseFromIndex(nameIndex, info.name, info.id);
+}
+
+void Scene::setEntityName(EntityID id, std::string_view name)
+{
+    auto& info = getComponent<ObjectInfoComponent>(id);
+    if (info.name == name) return;
+
+    eraseFromIndex(nameIndex, info.name, id);
+    info.name = name;
+    if (!info.name.empty()) insertIntoIndex(nameIndex[info.name], id);
+}
+
+void Scene::setEntityTag(EntityID id, std::string_view tag)
+{
+    auto& info = getComponent<ObjectInfoComponent>(id);
+    if (info.tag == tag) return;
+
+    eraseFromIndex(tagIndex, info.tag, id);
+    info.tag = tag;
+    if (!info.tag.empty()) insertIntoIndex(tagIndex[info.tag], id);
+}
+
+void Scene::setEntityUuid(EntityID id, std::string_view uuid)
+{
+    auto& info = getComponent<ObjectInfoComponent>(id);
+    if (info.uuid == uuid) return;
+
+    if (auto it = uuidIndex.find(info.uuid); it != uuidIndex.end() && it->second == id) {
+        uuidIndex.erase(it);
+    }
+    info.uuid = uuid;
+    if (!info.uuid.empty()) uuidIndex[info.uuid] = id;
+}
+
+EntityID Scene::findEntityByUuid(std::string_view uuid) const
+{
+    auto it = uuidIndex.find(uuid);
+    return it != uuidIndex.end() ? it->second : (EntityID)-1;
+}
+
+static const std::vector<EntityID> noEntities;
+
+const std::vector<EntityID>& Scene::findEntitiesByTag(std::string_view tag) const
+{
+    auto it = tagIndex.find(tag);
+    return it != tagIndex.end() ? it->second : noEntities;
+}
+
+const std::vector<EntityID>& Scene::findEntitiesByName(std::string_view name) const
+{
+    auto it = nameIndex.find(name);
+    return it != nameIndex.end() ? it->second : noEntities;
+}
+
+bool Scene::hasTag(EntityID id, std::string_view tag) const
+{
+    auto infos = getStorage<ObjectInfoComponent>();
+    return infos && infos->has(id) && infos->get(id).tag == tag;
+}
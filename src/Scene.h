@@ -7,9 +7,13 @@
 #include "ECS/Components.h"
 #include "ECS/ComponentStorage.h"
 #include "ECS/EntityManager.h"
+#include "ECS/View.h"
+#include "ECS/CommandBuffer.h"
+#include "ECS/EntityPool.h"
 #include <unordered_map>
-#include <typeindex>
 #include <memory>
+#include <span>
+#include <string_view>
 
 #include "ECS/TransformSystem.h"
 #include "ECS/RenderingSystem.h"
@@ -19,33 +23,78 @@
 #include "uuid.h"
 
 class Application;
+class PrefabTemplate;
 
 class Scene {
 private:
+    friend class CommandBuffer;
+
     Application* app = nullptr;
 
-    std::unordered_map<std::type_index, std::unique_ptr<IComponentStorage>> storages;
+    // indeksowane przez componentTypeId<T>(), puste miejsca dla typów bez storage w tej scenie.
+    // Kopia sceny współdzieli storage (copy-on-write) - klonowany jest dopiero przy pierwszym zapisie.
+    std::vector<std::shared_ptr<IComponentStorage>> storages;
     EntityManager entityManager;
     TransformSystem transformSystem = TransformSystem(this);
     RenderingSystem renderingSystem = RenderingSystem(this);
     CollisionSystem collisionSystem = CollisionSystem(this);
     EventSystem eventSystem = EventSystem();
 	FlyAISystem flyAISystem = FlyAISystem(this);
+    CommandBuffer commandBuffer = CommandBuffer(this);
+    EntityPool entityPool = EntityPool(this);
 
 
     EntityID sceneGraphRoot = 0;
 
+    // licznik zmian - zapisy komponentów dostają aktualny tick, systemy pamiętają tick ostatniej synchronizacji
+    uint32_t changeTick = 1;
+
+    // bufory robocze destroyEntities, używane ponownie między wywołaniami (nie kopiowane z innej sceny)
+    struct DestroyScratch {
+        std::vector<EntityID> roots;
+        std::vector<uint8_t> rootVisited;
+        std::vector<EntityID> doomed;
+        std::vector<EntityID> sortedDoomed;
+        std::vector<EntityID> stack;
+        std::vector<EntityID> survivingParents;
+    };
+    DestroyScratch destroyScratch;
+
+    // heterogeniczne wyszukiwanie - find(std::string_view) bez tworzenia std::string
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+    };
+    template<typename V>
+    using StringIndex = std::unordered_map<std::string, V, StringHash, std::equal_to<>>;
+
+    // indeksy ObjectInfoComponent, aktualizowane przy dodaniu/usunięciu komponentu i w setEntity*()
+    // puste nazwy/tagi/uuid nie są indeksowane
+    StringIndex<EntityID> uuidIndex;
+    StringIndex<std::vector<EntityID>> tagIndex;
+    StringIndex<std::vector<EntityID>> nameIndex;
+
+    void indexObjectInfo(const ObjectInfoComponent& info);
+    void unindexObjectInfo(const ObjectInfoComponent& info);
+
+    static void detachStorage(std::shared_ptr<IComponentStorage>& storage) {
+        if (storage.use_count() > 1) {
+            storage = std::shared_ptr<IComponentStorage>(storage->clone());
+        }
+    }
+
     template<typename T>
     ComponentStorage<T>* getOrCreateStorage() {
-        auto type = std::type_index(typeid(T));
-        auto it = storages.find(type);
-        if (it == storages.end()) {
-            auto storage = std::make_unique<ComponentStorage<T>>();
-            auto ptr = storage.get();
-            storages[type] = std::move(storage);
-            return ptr;
+        ComponentTypeID type = componentTypeId<T>();
+        if (type >= storages.size()) {
+            storages.resize(type + 1);
+        }
+        if (!storages[type]) {
+            storages[type] = std::make_shared<ComponentStorage<T>>();
+        } else {
+            detachStorage(storages[type]);
         }
-        return static_cast<ComponentStorage<T>*>(it->second.get());
+        return static_cast<ComponentStorage<T>*>(storages[type].get());
     }
 public:
 
@@ -53,12 +102,22 @@ public:
 
     Scene(const Scene& other);
 
+    // Przywraca encje i komponenty z kopii (np. powrót z trybu gry w edytorze), storage współdzielone jak w kopii.
+    // Listenery EventSystem i CollisionSystem zostają - bez ponownej rejestracji; kolejka zdarzeń jest czyszczona.
+    void restoreFrom(const Scene& backup);
+
     Scene& operator=(const Scene&) = delete; // Wyłączenie przypisania
     Scene(Scene&&) = default; // Przenoszenie dozwolone
     Scene& operator=(Scene&&) = default;
 
     EntityID getSceneRootEntity() const { return sceneGraphRoot; }
 
+    uint32_t getChangeTick() const { return changeTick; }
+
+    // Zwraca tick, do którego zmiany zostały już przetworzone przez wołającego, i przesuwa licznik.
+    // Zmiany zapisane później mają większy tick, więc trafią do następnego changedSince(id, zwrócony tick).
+    uint32_t advanceChangeTick() { return changeTick++; }
+
     TransformSystem& getTransformSystem() {
         return transformSystem;
     }
@@ -78,16 +137,32 @@ public:
 		return flyAISystem;
 	}
 
+    // zmiany struktury w trakcie iteracji po storage - wykonywane w Application::update po systemach
+    CommandBuffer& getCommandBuffer() {
+        return commandBuffer;
+    }
+
+    EntityPool& getEntityPool() {
+        return entityPool;
+    }
+
     template<typename T>
     T& addComponent(EntityID id, const T& value = T{}) {
-        getOrCreateStorage<T>()->add(id, value);
-        return getComponent<T>(id);
+        auto storage = getOrCreateStorage<T>();
+        storage->add(id, value, changeTick);
+        if constexpr (std::is_same_v<T, ObjectInfoComponent>) {
+            indexObjectInfo(storage->get(id));
+        }
+        return storage->get(id);
     }
 
     template<typename T>
     void removeComponent(EntityID id) {
         auto storage = getStorage<T>();
         if (storage) {
+            if constexpr (std::is_same_v<T, ObjectInfoComponent>) {
+                unindexObjectInfo(storage->get(id));
+            }
             storage->remove(id);
         }
     }
@@ -98,23 +173,73 @@ public:
         return storage && storage->has(id);
     }
 
+    bool hasComponent(ComponentTypeID type, EntityID id) const {
+        return type < storages.size() && storages[type] && storages[type]->has(id);
+    }
+
+    // dostęp do zapisu - oznacza komponent jako zmieniony; do samego odczytu lepiej const Scene& albo getStorage()
     template<typename T>
     T& getComponent(EntityID id) {
-        return getOrCreateStorage<T>()->get(id);
+        return getOrCreateStorage<T>()->getForWrite(id, changeTick);
+    }
+
+    template<typename T>
+    void markChanged(EntityID id) {
+        getOrCreateStorage<T>()->markChanged(id, changeTick);
+    }
+
+    template<typename T>
+    bool changedSince(EntityID id, uint32_t tick) const {
+        auto storage = getStorage<T>();
+        return storage && storage->has(id) && storage->changedSince(id, tick);
+    }
+
+    template<typename T>
+    const T& getComponent(EntityID id) const {
+        auto storage = getStorage<T>();
+        assert(storage && "Scene: trying to get a component without storage");
+        return storage->get(id);
     }
 
     template<typename T>
     T* getComponentArray() {
         auto storage = getStorage<T>();
         if (!storage) return nullptr;
-        return storage->components;
+        return storage->components.data();
     }
 
+    // dostęp do zapisu - odłącza storage współdzielony z kopią sceny
     template<typename T>
-    ComponentStorage<T>* getStorage() const {
-        auto it = storages.find(std::type_index(typeid(T)));
-        if (it == storages.end()) return nullptr;
-        return static_cast<ComponentStorage<T>*>(it->second.get());
+    ComponentStorage<T>* getStorage() {
+        ComponentTypeID type = componentTypeId<T>();
+        if (type >= storages.size() || !storages[type]) return nullptr;
+        detachStorage(storages[type]);
+        return static_cast<ComponentStorage<T>*>(storages[type].get());
+    }
+
+    template<typename T>
+    const ComponentStorage<T>* getStorage() const {
+        ComponentTypeID type = componentTypeId<T>();
+        if (type >= storages.size()) return nullptr;
+        return static_cast<const ComponentStorage<T>*>(storages[type].get());
+    }
+
+    // Tworzy lub odłącza storage z wyprzedzeniem. Później getStorage<T>()/getComponent<T>() nie zmieniają
+    // tablicy storage, więc systemy z SystemScheduler mogą z nich korzystać równolegle.
+    template<typename T>
+    void prepareStorage() {
+        getOrCreateStorage<T>();
+    }
+
+    // Encje posiadające wszystkie podane komponenty, np. scene.view<Transform, VelocityComponent>()
+    template<typename... Ts>
+    View<Ts...> view() {
+        return View<Ts...>(getStorage<Ts>()...);
+    }
+
+    template<typename... Ts>
+    View<const Ts...> view() const {
+        return View<const Ts...>(getStorage<Ts>()...);
     }
 
 
@@ -124,12 +249,34 @@ public:
 
 
     void destroyEntity(EntityID id);
+    // Niszczy encje razem z poddrzewami: najpierw zbiera cały zbiór, potem każdy storage
+    // jest czyszczony jednym przebiegiem, a listy dzieci rodziców poprawiane raz na rodzica.
+    void destroyEntities(std::span<const EntityID> ids);
 
 	bool hasEntity(EntityID id) const;
 
+    // false dla instancji odłożonej do EntityPool (Transform::isActive == false) - systemy gry ją pomijają
+    bool isActive(EntityID id) const {
+        auto transforms = getStorage<Transform>();
+        return !transforms || !transforms->has(id) || transforms->get(id).isActive;
+    }
+
 	const std::vector<EntityID>& getEntities() const;
 
     std::vector<EntityID> instantiatePrefab(const std::string& prefabName, EntityID parent = (EntityID)-1);
+    // nullptr, jeśli nie ma takiego prefabu (albo scena nie należy do aplikacji)
+    const PrefabTemplate* findPrefab(const std::string& prefabName) const;
+
+    // zmiany name/tag/uuid muszą iść przez te metody, bezpośredni zapis do ObjectInfoComponent rozspójni indeksy
+    void setEntityName(EntityID id, std::string_view name);
+    void setEntityTag(EntityID id, std::string_view tag);
+    void setEntityUuid(EntityID id, std::string_view uuid);
+
+    // (EntityID)-1 jeśli nie ma encji o takim uuid
+    EntityID findEntityByUuid(std::string_view uuid) const;
+    const std::vector<EntityID>& findEntitiesByTag(std::string_view tag) const;
+    const std::vector<EntityID>& findEntitiesByName(std::string_view name) const;
+    bool hasTag(EntityID id, std::string_view tag) const;
 
 };
 
@@ -76,10 +76,9 @@ namespace Serialization
 	static json entity_to_json(EntityID entity, const SerializationContext& context)
 	{
 		json j;
-		auto it = context.uuidMap.find(entity);
-		if (it != context.uuidMap.end())
+		if (context.selection.find(entity) != context.selection.end())
 		{
-			j = it->second;
+			j = context.scene.getComponent<ObjectInfoComponent>(entity).uuid;
 		}
 		else
 		{
@@ -90,10 +89,15 @@ namespace Serialization
 
 	static EntityID entity_from_json(const json& j, const DeserializationContext& context)
 	{
-		if (j.is_string() && !j.get<std::string>().empty())
+		if (j.is_string() && !j.get_ref<const std::string&>().empty())
 		{
-			auto it = context.uuidMap.find(j.get<std::string>());
-			if (it != context.uuidMap.end())
+			const std::string& uuid = j.get_ref<const std::string&>();
+			if (!context.uuidMap)
+			{
+				return context.scene.findEntityByUuid(uuid);
+			}
+			auto it = context.uuidMap->find(uuid);
+			if (it != context.uuidMap->end())
 			{
 				return it->second;
 			}
@@ -128,37 +132,38 @@ namespace Serialization
 		}
 	}
 
-	static void to_json(nlohmann::json& j, const Transform& c, const SerializationContext& context)
+	// Transform i TransformInfoComponent zapisywane razem jako "Transform"
+	static void to_json(nlohmann::json& j, const Transform& c, const TransformInfoComponent& info, const SerializationContext& context)
 	{
 		j["isStatic"] = c.isStatic;
 		j["translation"] = c.translation;
 		j["rotation"] = c.rotation;
-		j["eulerRotation"] = c.eulerRotation;
+		j["eulerRotation"] = info.eulerRotation;
 		j["scale"] = c.scale;
 		j["parent"] = entity_to_json(c.parent, context);
 		j["children"] = nlohmann::json::array();
-		for (const auto& child : c.children)
+		for (const auto& child : info.children)
 		{
 			j["children"].push_back(entity_to_json(child, context));
 		}
 
 	}
 
-	static void from_json(const nlohmann::json& j, Transform& c, const DeserializationContext& context)
+	static void from_json(const nlohmann::json& j, Transform& c, TransformInfoComponent& info, const DeserializationContext& context)
 	{
 		j.at("isStatic").get_to(c.isStatic);
 		j.at("translation").get_to(c.translation);
 		j.at("rotation").get_to(c.rotation);
-		j.at("eulerRotation").get_to(c.eulerRotation);
+		j.at("eulerRotation").get_to(info.eulerRotation);
 		j.at("scale").get_to(c.scale);
 		c.parent = entity_from_json(j.at("parent"), context);
-		c.children.clear();
+		info.children.clear();
 		for (const auto& child : j.at("children"))
 		{
 			EntityID childId = entity_from_json(child, context);
 			if (childId != (EntityID)-1)
 			{
-				c.children.push_back(childId);
+				info.children.push_back(childId);
 			}
 		}
 	}
@@ -315,7 +320,7 @@ namespace Serialization
 			c.fovSizeAxis = CameraComponent::FovSizeAxis::HORIZONTAL;
 	}
 
-	static void to_json(nlohmann::json& j, PointLightComponent& c, const SerializationContext& context)
+	static void to_json(nlohmann::json& j, const PointLightComponent& c, const SerializationContext& context)
 	{
 		j["color"] = c.color;
 		j["intensity"] = c.intensity;
@@ -586,7 +591,7 @@ namespace Serialization
 		c.targetID = entity_from_json(j.at("targetID"), context);
 	}
 
-	static void to_json(nlohmann::json& j, SplitScreenController& c, const SerializationContext& context)
+	static void to_json(nlohmann::json& j, const SplitScreenController& c, const SerializationContext& context)
 	{
 		j["offset"] = c.offset;
 		j["target1"] = entity_to_json(c.target1, context);
@@ -604,7 +609,7 @@ namespace Serialization
 		c.camera2 = entity_from_json(j.at("camera2"), context);
 	}
 
-	void saveScene(const std::string& filePath, Scene& scene)
+	void saveScene(const std::string& filePath, const Scene& scene)
 	{
 		std::ofstream file(filePath);
 		if (file.is_open())
@@ -637,7 +642,7 @@ namespace Serialization
 
 
 
-	json serializeScene(Scene& scene)
+	json serializeScene(const Scene& scene)
 	{
 		json sceneJson;
 
@@ -654,7 +659,7 @@ namespace Serialization
 	{
 		EntityID sceneRoot = scene.getSceneRootEntity();
 
-		scene.getComponent<ObjectInfoComponent>(sceneRoot).name = sceneJson["sceneRoot"].get<std::string>();
+		scene.setEntityName(sceneRoot, sceneJson["sceneRoot"].get<std::string>());
 
 		deserializeObjects(sceneJson, scene, sceneRoot, context);
 	}
@@ -662,21 +667,21 @@ namespace Serialization
 	struct FullEntitySelection
 	{
 		std::vector<EntityID> selectedEntities;
-		std::unordered_set<EntityID> roots;
+		// te same encje co selectedEntities - do sprawdzania, czy referencja wskazuje na zapisywany obiekt
+		std::unordered_set<EntityID> members;
 	};
 
-	static FullEntitySelection getSelectedTree(const std::vector<EntityID>& selection, Scene& scene)
+	static FullEntitySelection getSelectedTree(const std::vector<EntityID>& selection, const Scene& scene)
 	{
 		FullEntitySelection result;
 		EntityID sceneRoot = scene.getSceneRootEntity();
-		result.roots.insert(sceneRoot);
 
 		std::stack<EntityID> stack;
 		for (auto it = selection.rbegin(); it != selection.rend(); ++it)
 		{
 			stack.push(*it);
 		}
-		std::unordered_set<EntityID> visited;
+		std::unordered_set<EntityID>& visited = result.members;
 
 		while (!stack.empty())
 		{
@@ -690,56 +695,38 @@ namespace Serialization
 			if (id != sceneRoot)
 				result.selectedEntities.push_back(id);
 
-			auto& transform = scene.getComponent<Transform>(id);
-			for (auto it = transform.children.rbegin(); it != transform.children.rend(); ++it)
+			auto& info = scene.getComponent<TransformInfoComponent>(id);
+			for (auto it = info.children.rbegin(); it != info.children.rend(); ++it)
 			{
 				if (visited.find(*it) == visited.end())
 					stack.push(*it);
 			}
 		}
-
-		for (auto& id : selection)
-		{
-			if (id == sceneRoot)
-				continue;
-
-			auto& transform = scene.getComponent<Transform>(id);
-			if (visited.find(transform.parent) == visited.end())
-			{
-				result.roots.insert(transform.parent);
-			}
-		}
-
+		visited.erase(sceneRoot);
 
 		return result;
 	}
 
-	json serializeObjects(const std::vector<EntityID>& objects, Scene& scene)
+	json serializeObjects(const std::vector<EntityID>& objects, const Scene& scene)
 	{
 		// rooty chyba ju� nie s� potrzebne
-		auto [entities, roots] = getSelectedTree(objects, scene);
+		auto [entities, members] = getSelectedTree(objects, scene);
 		json selectionJson;
 
-		std::unordered_map<EntityID, std::string> entityToUuidMap;
-		/*for (auto& root : roots)
-		{
-			entityToUuidMap[root] = "";
-		}*/
-
-		for (auto& entity : entities)
-		{
-			auto& objectInfo = scene.getComponent<ObjectInfoComponent>(entity);
-			entityToUuidMap[entity] = objectInfo.uuid;
-		}
 		SerializationContext context{
-			.uuidMap = entityToUuidMap
+			.scene = scene,
+			.selection = members
 		};
 
 		for (auto& entity : entities)
 		{
 			json entityJson;
 			serializeComponent(ObjectInfoComponent);
-			serializeComponent(Transform);
+			if (scene.hasComponent<Transform>(entity))
+			{
+				to_json(entityJson["Transform"], scene.getComponent<Transform>(entity),
+					scene.getComponent<TransformInfoComponent>(entity), context);
+			}
 
 			serializeComponent(ModelComponent);
 			serializeComponent(ImageComponent);
@@ -776,33 +763,57 @@ namespace Serialization
 
 	std::vector<EntityID> deserializeObjects(nlohmann::json objectsJson, Scene& scene, EntityID rootParent, const GlobalDeserializationContext& gContext)
 	{
-		std::unordered_map<std::string, EntityID> uuidToEntityMap = { {"", (EntityID)-1}};
+		// wczytywane uuid trafiają od razu do indeksu sceny; prefaby i kopie dostają nowe uuid,
+		// więc referencje wewnątrz wklejanego drzewa rozwiązuje lokalna mapa
+		std::unordered_map<std::string, EntityID> uuidToEntityMap;
 		std::vector<EntityID> deserializedEntities;
+		deserializedEntities.reserve(objectsJson["entities"].size());
 		for (const auto& entityJson : objectsJson["entities"])
 		{
 			EntityID entity = scene.createEntity((EntityID)-1);
-			uuidToEntityMap[entityJson["ObjectInfoComponent"]["uuid"].get<std::string>()] = entity;
+			const std::string& fileUuid = entityJson["ObjectInfoComponent"]["uuid"].get_ref<const std::string&>();
+			if (gContext.deserializeUuid)
+				scene.setEntityUuid(entity, fileUuid);
+			else
+				uuidToEntityMap[fileUuid] = entity;
 			deserializedEntities.push_back(entity);
 		}
 
 		auto& ts = scene.getTransformSystem();
+		// rodzice i listy dzieci ustawiane niżej bezpośrednio z JSON-a
+		ts.invalidateHierarchy();
 
 		DeserializationContext context{
 			.shaders = gContext.shaders,
 			.models = gContext.models,
-			.uuidMap = uuidToEntityMap,
+			.scene = scene,
+			.uuidMap = gContext.deserializeUuid ? nullptr : &uuidToEntityMap,
 			.deserializeUuid = gContext.deserializeUuid
 		};
 
 		EntityID sceneRoot = scene.getSceneRootEntity();
-		auto& sceneRootTransform = scene.getComponent<Transform>(sceneRoot);
+		auto& sceneRootInfo = scene.getComponent<TransformInfoComponent>(sceneRoot);
 
+		size_t position = 0;
 		for (auto& entityJson : objectsJson["entities"])
 		{
-			EntityID entity = uuidToEntityMap[entityJson["ObjectInfoComponent"]["uuid"].get<std::string>()];
+			EntityID entity = deserializedEntities[position++];
 
-			deserializeExistingComponent(ObjectInfoComponent);
-			deserializeExistingComponent(Transform);
+			if (entityJson.contains("ObjectInfoComponent"))
+			{
+				// przez settery sceny - aktualizują indeksy uuid/tag/nazwa
+				ObjectInfoComponent info = std::as_const(scene).getComponent<ObjectInfoComponent>(entity);
+				from_json(entityJson["ObjectInfoComponent"], info, context);
+				scene.setEntityName(entity, info.name);
+				scene.setEntityTag(entity, info.tag);
+				scene.setEntityUuid(entity, info.uuid);
+			}
+			if (entityJson.contains("Transform"))
+			{
+				auto& transform = scene.getComponent<Transform>(entity);
+				from_json(entityJson["Transform"], transform, scene.getComponent<TransformInfoComponent>(entity), context);
+				transform.id = entity;
+			}
 
 			// set relationships properly
 			{
@@ -812,7 +823,7 @@ namespace Serialization
 
 				if (parentId != sceneRoot)
 				{
-					std::erase(sceneRootTransform.children, entity);
+					std::erase(sceneRootInfo.children, entity);
 				}
 
 				if (parentId == (EntityID)-1)
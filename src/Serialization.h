@@ -1,6 +1,7 @@
 #pragma once
 
 #include <nlohmann/json.hpp>
+#include <unordered_set>
 #include <vector>
 #include "Scene.h"
 
@@ -10,7 +11,9 @@ class Model;
 namespace Serialization
 {
 	struct SerializationContext {
-		const std::unordered_map<EntityID, std::string>& uuidMap;
+		const Scene& scene;
+		// referencje do encji spoza zaznaczenia zapisywane są jako ""
+		const std::unordered_set<EntityID>& selection;
 	};
 
 	struct GlobalDeserializationContext {
@@ -22,17 +25,19 @@ namespace Serialization
 	struct DeserializationContext {
 		std::vector<Shader*>& shaders;
 		std::vector<Model*>& models;
-		const std::unordered_map<std::string, EntityID>& uuidMap;
+		const Scene& scene;
+		// uuid z pliku -> nowa encja; nullptr gdy uuid są wczytywane i wystarcza indeks sceny
+		const std::unordered_map<std::string, EntityID>* uuidMap;
 		bool deserializeUuid;
 	};
 
-	void saveScene(const std::string& filePath, Scene& scene);
+	void saveScene(const std::string& filePath, const Scene& scene);
 	void loadScene(const std::string& filePath, Scene& scene, const GlobalDeserializationContext& context);
 
-	nlohmann::json serializeScene(Scene& scene);
+	nlohmann::json serializeScene(const Scene& scene);
 	void deserializeScene(nlohmann::json sceneJson, Scene& scene, const GlobalDeserializationContext& context);
 
-	nlohmann::json serializeObjects(const std::vector<EntityID>& objects, Scene& scene);
+	nlohmann::json serializeObjects(const std::vector<EntityID>& objects, const Scene& scene);
 	std::vector<EntityID> deserializeObjects(nlohmann::json objectsJson, Scene& scene, EntityID rootParent, const GlobalDeserializationContext& context);
 
 	std::vector<Shader*> loadShaderList(const std::string& filePath, std::vector<Shader*>& shaders);
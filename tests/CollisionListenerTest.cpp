@@ -0,0 +1,127 @@
+// CollisionSystem::onCollision zwraca ListenerHandle: usunięcie listenera (także w trakcie obsługi zdarzenia),
+// ponowne użycie slotu bez zmiany kolejności rejestracji, dodanie listenera z wnętrza obsługi.
+
+#include "TestCheck.h"
+
+#include "Scene.h"
+
+#include <string>
+
+namespace {
+
+    struct Fixture {
+        Scene scene{ nullptr };
+        EntityID mover = (EntityID)-1;
+        EntityID wall = (EntityID)-1;
+
+        // dwa nachodzące na siebie prostopadłościany, ruchomy ma VelocityComponent
+        Fixture()
+        {
+            mover = scene.createEntity();
+            wall = scene.createEntity();
+            scene.addComponent<ColliderComponent>(mover, ColliderComponent(ColliderType::BOX));
+            scene.addComponent<ColliderComponent>(wall, ColliderComponent(ColliderType::BOX));
+            scene.addComponent<VelocityComponent>(mover, VelocityComponent{});
+            scene.getTransformSystem().update();
+        }
+
+        void step()
+        {
+            scene.getCollisionSystem().CheckCollisions();
+            scene.getEventSystem().processEvents();
+        }
+    };
+
+    void testRemove()
+    {
+        Fixture fixture;
+        auto& collisions = fixture.scene.getCollisionSystem();
+        std::string calls;
+
+        ListenerHandle velocity = collisions.onCollision<VelocityComponent>([&](const CollisionEvent&) { calls += 'v'; });
+        ListenerHandle pair = collisions.onCollision<VelocityComponent, ColliderComponent>([&](const CollisionEvent&) { calls += 'p'; });
+        ListenerHandle wall = collisions.onCollision(fixture.wall, [&](const CollisionEvent&) { calls += 'w'; });
+        ListenerHandle any = collisions.onCollision<ColliderComponent>([&](const CollisionEvent&) { calls += 'a'; });
+        CHECK(velocity.isValid() && pair.isValid() && wall.isValid() && any.isValid());
+
+        // zdarzenie (mover, wall), potem (wall, mover); w obrębie zdarzenia kolejność rejestracji
+        fixture.step();
+        CHECK(calls == "vpawa");
+
+        CHECK(collisions.unregisterListener(pair));
+        CHECK(!pair.isValid());
+        CHECK(!collisions.unregisterListener(pair));
+        calls.clear();
+        fixture.step();
+        CHECK(calls == "vawa");
+
+        // uchwyt z CollisionSystem nie usuwa listenera EventSystem i odwrotnie
+        ListenerHandle copy = wall;
+        CHECK(!fixture.scene.getEventSystem().unregisterListener(copy));
+        ListenerHandle eventHandle = fixture.scene.getEventSystem().registerListener<CollisionEvent>([](const Event&) {});
+        ListenerHandle eventCopy = eventHandle;
+        CHECK(!collisions.unregisterListener(eventCopy));
+        CHECK(fixture.scene.getEventSystem().unregisterListener(eventHandle));
+
+        // zwolniony slot użyty ponownie - nowy listener i tak po wszystkich starszych
+        ListenerHandle late = collisions.onCollision<VelocityComponent>([&](const CollisionEvent&) { calls += 'l'; });
+        CHECK(late.slot == 1);
+        calls.clear();
+        fixture.step();
+        CHECK(calls == "valwa");
+
+        // stary uchwyt do tego samego slotu nie usuwa nowego listenera
+        ListenerHandle stale = late;
+        stale.generation--;
+        CHECK(!collisions.unregisterListener(stale));
+
+        CHECK(collisions.unregisterListener(wall));
+        CHECK(collisions.unregisterListener(velocity));
+        CHECK(collisions.unregisterListener(late));
+        CHECK(collisions.unregisterListener(any));
+        calls.clear();
+        fixture.step();
+        CHECK(calls.empty());
+    }
+
+    void testChangesDuringDispatch()
+    {
+        Fixture fixture;
+        auto& collisions = fixture.scene.getCollisionSystem();
+        std::string calls;
+
+        ListenerHandle second;
+        ListenerHandle added;
+        collisions.onCollision<VelocityComponent>([&](const CollisionEvent&)
+            {
+                calls += 'f';
+                // usunięty listener tego samego zdarzenia nie jest już wywołany
+                if (second.isValid())
+                    CHECK(collisions.unregisterListener(second));
+                // dodany działa od następnego processEvents; można go usunąć od razu
+                if (!added.isValid())
+                {
+                    added = collisions.onCollision<VelocityComponent>([&](const CollisionEvent&) { calls += 'n'; });
+                    ListenerHandle removedAtOnce = collisions.onCollision<ColliderComponent>([&](const CollisionEvent&) { calls += 'x'; });
+                    CHECK(collisions.unregisterListener(removedAtOnce));
+                }
+            });
+        second = collisions.onCollision<VelocityComponent>([&](const CollisionEvent&) { calls += 's'; });
+
+        fixture.step();
+        CHECK(calls == "f");
+
+        calls.clear();
+        fixture.step();
+        CHECK(calls == "fn");
+        CHECK(collisions.unregisterListener(added));
+    }
+
+}
+
+int main()
+{
+    testRemove();
+    testChangesDuringDispatch();
+    return TestCheck::finish();
+}
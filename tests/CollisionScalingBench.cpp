@@ -0,0 +1,72 @@
+// Skalowanie CollisionSystem::CheckCollisions (pętla par na JobSystem::parallelFor) od 1 do N wątków
+// na syntetycznej scenie: losowe sfery i prostopadłościany, co czwarty collider statyczny.
+// Sprawdza też, że lista kolizji jest taka sama i w tej samej kolejności co na 1 wątku.
+// Użycie: CollisionScalingBench [liczba colliderów, domyślnie 2000] [maksymalna liczba wątków, domyślnie 8]
+
+#include "JobSystem.h"
+#include "Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    int colliderCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    uint32_t maxThreads = argc > 2 ? static_cast<uint32_t>(std::atoi(argv[2])) : 8;
+
+    Scene scene(nullptr);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    for (int i = 0; i < colliderCount; i++)
+    {
+        EntityID id = scene.createEntity();
+        scene.getTransformSystem().translateEntity(id, glm::vec3(position(rng), position(rng) * 0.1f, position(rng)));
+        ColliderComponent collider(i % 3 ? ColliderType::BOX : ColliderType::SPHERE, i % 4 == 0);
+        collider.GetColliderShape()->center = glm::vec3(0.0f);
+        scene.addComponent<ColliderComponent>(id, std::move(collider));
+    }
+    scene.getTransformSystem().update();
+
+    std::printf("%d colliders, hardware threads: %u, best of 15\n", colliderCount, std::thread::hardware_concurrency());
+
+    auto& collisionSystem = scene.getCollisionSystem();
+    std::vector<std::pair<EntityID, EntityID>> reference;
+    double serial = 0.0;
+    bool identical = true;
+    for (uint32_t threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        JobSystem::GetInstance().setThreadCount(threads);
+
+        double best = 1e30;
+        for (int repeat = 0; repeat < 15; repeat++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            collisionSystem.CheckCollisions();
+            // zdarzenia kolizji z kolejki - inaczej rosłyby z każdym powtórzeniem
+            scene.getEventSystem().processEvents();
+            best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        }
+
+        std::vector<std::pair<EntityID, EntityID>> pairs;
+        for (const auto& collision : collisionSystem.GetCollisions())
+        {
+            pairs.emplace_back(collision.objectA, collision.objectB);
+        }
+        if (threads == 1)
+        {
+            reference = pairs;
+            serial = best;
+        }
+        bool same = pairs == reference;
+        identical &= same;
+        std::printf("threads %u: %8.2f ms, speedup %5.2fx, %zu collisions, same order as 1 thread: %s\n",
+            threads, best, serial / best, pairs.size(), same ? "yes" : "NO");
+    }
+    return identical ? 0 : 1;
+}
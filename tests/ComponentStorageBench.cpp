@@ -0,0 +1,129 @@
+// Koszt pobrania storage komponentu: gęsty ComponentTypeID (Scene::getStorage<T>) kontra
+// dawna mapa std::unordered_map<std::type_index, ...> odtworzona tutaj na tych samych storage.
+// Scena: 10k encji, Transform na wszystkich, VelocityComponent na połowie, ButterHealthComponent na co trzeciej.
+// Użycie: ComponentStorageBench
+
+#include "Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // jak dawne Scene::getStorage<T>() - wyszukanie po typeid w mapie
+    class TypeIndexLookup {
+    public:
+        template<typename T>
+        void add(const ComponentStorage<T>* storage) {
+            storages[std::type_index(typeid(T))] = storage;
+        }
+
+        template<typename T>
+        const ComponentStorage<T>* get() const {
+            auto it = storages.find(std::type_index(typeid(T)));
+            if (it == storages.end()) return nullptr;
+            return static_cast<const ComponentStorage<T>*>(it->second);
+        }
+
+    private:
+        std::unordered_map<std::type_index, const IComponentStorage*> storages;
+    };
+
+    template<typename Body>
+    double bestNanoseconds(size_t operations, Body&& body)
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < 5; repeat++)
+        {
+            auto start = Clock::now();
+            body();
+            best = std::min(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / operations);
+        }
+        return best;
+    }
+
+}
+
+int main()
+{
+    Scene scene(nullptr);
+    std::vector<EntityID> ids;
+    for (int i = 0; i < 10000; i++)
+    {
+        EntityID id = scene.createEntity();
+        ids.push_back(id);
+        if (i % 2 == 0)
+            scene.addComponent<VelocityComponent>(id, VelocityComponent{});
+        if (i % 3 == 0)
+            scene.addComponent<ButterHealthComponent>(id, ButterHealthComponent{});
+    }
+
+    const Scene& constScene = scene;
+    TypeIndexLookup map;
+    map.add(constScene.getStorage<Transform>());
+    map.add(constScene.getStorage<VelocityComponent>());
+    map.add(constScene.getStorage<ButterHealthComponent>());
+
+    volatile float sink = 0.0f;
+    constexpr size_t STORAGE_CALLS = 3 * 1000000;
+
+    double denseStorage = bestNanoseconds(STORAGE_CALLS, [&]()
+        {
+            for (size_t k = 0; k < STORAGE_CALLS / 3; k++)
+            {
+                sink = sink + (constScene.getStorage<Transform>() != nullptr) +
+                    (constScene.getStorage<VelocityComponent>() != nullptr) +
+                    (constScene.getStorage<ButterHealthComponent>() != nullptr);
+            }
+        });
+    double mapStorage = bestNanoseconds(STORAGE_CALLS, [&]()
+        {
+            for (size_t k = 0; k < STORAGE_CALLS / 3; k++)
+            {
+                sink = sink + (map.get<Transform>() != nullptr) + (map.get<VelocityComponent>() != nullptr) +
+                    (map.get<ButterHealthComponent>() != nullptr);
+            }
+        });
+
+    // typowy dostęp po encji: hasComponent + dwa get przez storage
+    constexpr int ENTITY_PASSES = 100;
+    size_t entityVisits = ids.size() * ENTITY_PASSES;
+    double denseEntity = bestNanoseconds(entityVisits, [&]()
+        {
+            for (int pass = 0; pass < ENTITY_PASSES; pass++)
+            {
+                for (EntityID id : ids)
+                {
+                    if (constScene.hasComponent<VelocityComponent>(id))
+                        sink = sink + constScene.getStorage<VelocityComponent>()->get(id).velocity.x;
+                    sink = sink + constScene.getStorage<Transform>()->get(id).translation.x;
+                }
+            }
+        });
+    double mapEntity = bestNanoseconds(entityVisits, [&]()
+        {
+            for (int pass = 0; pass < ENTITY_PASSES; pass++)
+            {
+                for (EntityID id : ids)
+                {
+                    auto velocities = map.get<VelocityComponent>();
+                    if (velocities && velocities->has(id))
+                        sink = sink + map.get<VelocityComponent>()->get(id).velocity.x;
+                    sink = sink + map.get<Transform>()->get(id).translation.x;
+                }
+            }
+        });
+
+    std::printf("hardware threads: %u, best of 5, ns\n", std::thread::hardware_concurrency());
+    std::printf("%-44s %10s %14s\n", "", "dense ID", "type_index map");
+    std::printf("%-44s %10.2f %14.2f\n", "getStorage<T>() per call", denseStorage, mapStorage);
+    std::printf("%-44s %10.2f %14.2f\n", "hasComponent + 2x getStorage()->get / entity", denseEntity, mapEntity);
+    return 0;
+}
@@ -0,0 +1,91 @@
+// Koszt processEvents() na zdarzenie: zwykły listener (wywołanie na każde zdarzenie) kontra
+// listener wsadowy (jedno wywołanie z całą tablicą). Zdarzenia kolizji jak z CollisionSystem,
+// kolejkowanie poza pomiarem.
+// Użycie: EventDispatchBench
+
+#include "ECS/CollisionSystem.h"
+#include "ECS/EventSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int FRAMES = 100;
+
+    // ns na zdarzenie, najlepsze z 5 powtórzeń po FRAMES klatek
+    double measure(int contacts, int listenerCount, bool batch, float& sink)
+    {
+        EventSystem events;
+        for (int listener = 0; listener < listenerCount; listener++)
+        {
+            if (batch)
+            {
+                events.registerBatchListener<CollisionEvent>([&sink](std::span<const CollisionEvent> batchEvents)
+                    {
+                        for (const CollisionEvent& collision : batchEvents)
+                        {
+                            if (collision.isColliding && collision.separationVector.y > 0.0f)
+                                sink += collision.separationVector.y;
+                        }
+                    });
+            }
+            else
+            {
+                events.registerListener<CollisionEvent>([&sink](const Event& event)
+                    {
+                        const auto& collision = static_cast<const CollisionEvent&>(event);
+                        if (collision.isColliding && collision.separationVector.y > 0.0f)
+                            sink += collision.separationVector.y;
+                    });
+            }
+        }
+
+        double best = 1e30;
+        for (int repeat = 0; repeat < 5; repeat++)
+        {
+            double total = 0.0;
+            for (int frame = 0; frame < FRAMES; frame++)
+            {
+                for (int i = 0; i < contacts; i++)
+                {
+                    CollisionEvent collision;
+                    collision.isColliding = true;
+                    collision.objectA = i;
+                    collision.objectB = i + 1;
+                    collision.separationVector = glm::vec3(0.0f, (i % 3) - 1.0f, 0.0f);
+                    events.queueEvent(collision);
+                }
+                auto start = Clock::now();
+                events.processEvents();
+                total += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+            }
+            best = std::min(best, total / FRAMES / contacts);
+        }
+        return best;
+    }
+
+}
+
+int main()
+{
+    float sink = 0.0f;
+    std::printf("hardware threads: %u, best of 5 x %d frames\n", std::thread::hardware_concurrency(), FRAMES);
+    std::printf("%8s %9s %14s %14s %8s\n", "contacts", "listeners", "per-event ns", "batch ns", "ratio");
+    for (int contacts : { 1000, 4000, 16000 })
+    {
+        for (int listeners : { 1, 4 })
+        {
+            double perEvent = measure(contacts, listeners, false, sink);
+            double batch = measure(contacts, listeners, true, sink);
+            std::printf("%8d %9d %14.2f %14.2f %7.1fx\n", contacts, listeners, perEvent, batch, perEvent / batch);
+        }
+    }
+    // wynik użyty - pętle nie znikają przy optymalizacji
+    std::printf("(checksum %g)\n", sink);
+    return 0;
+}
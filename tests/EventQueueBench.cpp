@@ -0,0 +1,106 @@
+// Wysyłanie zdarzeń z wielu wątków naraz: bufory wątków (queueEventConcurrent) kontra
+// wspólna kolejka pod blokadą (queueEvent + std::mutex). Czas wysyłania i processEvents (scalenie).
+// Użycie: EventQueueBench [liczba zdarzeń]
+
+#include "ECS/CollisionSystem.h"
+#include "ECS/EventSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct Result {
+        double emitMilliseconds = 1e30;
+        double processMilliseconds = 1e30;
+    };
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    template<typename Emit>
+    Result measure(uint32_t threadCount, uint32_t eventCount, Emit&& emit)
+    {
+        EventSystem events;
+        float sink = 0.0f;
+        events.registerBatchListener<CollisionEvent>([&](std::span<const CollisionEvent> batch)
+            {
+                for (const CollisionEvent& event : batch)
+                    sink += event.separationVector.y;
+            });
+        events.prepareChannel<CollisionEvent>();
+
+        Result best;
+        for (int repeat = 0; repeat < 5; repeat++)
+        {
+            std::vector<std::thread> threads;
+            auto start = Clock::now();
+            for (uint32_t t = 0; t < threadCount; t++)
+            {
+                threads.emplace_back([&, t]()
+                    {
+                        uint32_t begin = eventCount * t / threadCount;
+                        uint32_t end = eventCount * (t + 1) / threadCount;
+                        for (uint32_t i = begin; i < end; i++)
+                        {
+                            CollisionEvent event;
+                            event.isColliding = true;
+                            event.objectA = i;
+                            event.objectB = i + 1;
+                            event.separationVector = glm::vec3(0.0f, 1.0f, 0.0f);
+                            emit(events, i, event);
+                        }
+                    });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            double emit = millisecondsSince(start);
+
+            start = Clock::now();
+            events.processEvents();
+            double process = millisecondsSince(start);
+
+            best.emitMilliseconds = std::min(best.emitMilliseconds, emit);
+            best.processMilliseconds = std::min(best.processMilliseconds, process);
+        }
+        if (sink < 0.0f)
+            std::printf("%f\n", sink);
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t eventCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 200000;
+    std::printf("%u events, hardware threads: %u, best of 5\n", eventCount, std::thread::hardware_concurrency());
+    std::printf("%8s %22s %22s\n", "threads", "locked queue emit/proc", "per-thread emit/proc");
+
+    std::mutex queueMutex;
+    for (uint32_t threads : { 1u, 2u, 4u, 8u })
+    {
+        Result locked = measure(threads, eventCount, [&](EventSystem& events, uint32_t, const CollisionEvent& event)
+            {
+                std::lock_guard lock(queueMutex);
+                events.queueEvent(event);
+            });
+        Result buffered = measure(threads, eventCount, [](EventSystem& events, uint32_t key, const CollisionEvent& event)
+            {
+                events.queueEventConcurrent(key, event);
+            });
+        std::printf("%8u %10.2f %10.2f ms %8.2f %10.2f ms\n", threads,
+            locked.emitMilliseconds, locked.processMilliseconds, buffered.emitMilliseconds, buffered.processMilliseconds);
+    }
+    return 0;
+}
@@ -0,0 +1,352 @@
+// EventSystem: listenery wsadowe dostają każde zdarzenie z kolejki w kolejności kolejkowania,
+// zdarzenia z wielu wątków (queueEventConcurrent) - kolejność po scaleniu
+// i sloty buforów wątków zwalniane przy zakończeniu wątku.
+
+#include "TestCheck.h"
+
+#include "JobSystem.h"
+#include "Scene.h"
+#include "ECS/CollisionSystem.h"
+#include "ECS/EventSystem.h"
+
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct NumberEvent : Event {
+        uint32_t producer = 0;
+        uint32_t value = 0;
+    };
+
+    struct OtherEvent : Event {
+        uint32_t value = 0;
+    };
+
+    // każde zdarzenie z queueEvent dokładnie raz, w kolejności kolejkowania - w każdym listenerze wsadowym,
+    // także przy przeplocie typów, zdarzeniach dokolejkowanych w trakcie obsługi i przez kilka klatek
+    void testBatchListenersReceiveEveryEvent()
+    {
+        EventSystem events;
+        std::vector<uint32_t> firstBatch;
+        std::vector<uint32_t> secondBatch;
+        std::vector<uint32_t> perEvent;
+        std::vector<uint32_t> other;
+        std::vector<size_t> batchSizes;
+
+        constexpr uint32_t FOLLOW_UP = 1000000;
+        events.registerListener<NumberEvent>([&](const Event& event)
+            {
+                perEvent.push_back(static_cast<const NumberEvent&>(event).value);
+            });
+        events.registerBatchListener<NumberEvent>([&](std::span<const NumberEvent> batch)
+            {
+                batchSizes.push_back(batch.size());
+                for (const NumberEvent& event : batch)
+                {
+                    firstBatch.push_back(event.value);
+                    // zdarzenie dokolejkowane w trakcie obsługi trafia do następnej partii tego samego processEvents
+                    if (event.value < FOLLOW_UP && event.value % 10 == 0)
+                    {
+                        NumberEvent followUp;
+                        followUp.value = FOLLOW_UP + event.value;
+                        events.queueEvent(followUp);
+                    }
+                }
+            });
+        events.registerBatchListener<NumberEvent>([&](std::span<const NumberEvent> batch)
+            {
+                for (const NumberEvent& event : batch)
+                {
+                    secondBatch.push_back(event.value);
+                }
+            });
+        events.registerBatchListener<OtherEvent>([&](std::span<const OtherEvent> batch)
+            {
+                for (const OtherEvent& event : batch)
+                {
+                    other.push_back(event.value);
+                }
+            });
+
+        uint32_t next = 0;
+        for (uint32_t frame = 0; frame < 5; frame++)
+        {
+            firstBatch.clear();
+            secondBatch.clear();
+            perEvent.clear();
+            other.clear();
+            batchSizes.clear();
+
+            std::vector<uint32_t> expected;
+            std::vector<uint32_t> expectedOther;
+            uint32_t count = 50 + frame * 37;
+            for (uint32_t i = 0; i < count; i++, next++)
+            {
+                NumberEvent event;
+                event.value = next;
+                events.queueEvent(event);
+                expected.push_back(next);
+                if (i % 3 == 0)
+                {
+                    OtherEvent otherEvent;
+                    otherEvent.value = next;
+                    events.queueEvent(otherEvent);
+                    expectedOther.push_back(next);
+                }
+            }
+            size_t queuedCount = expected.size();
+            for (size_t i = 0; i < queuedCount; i++)
+            {
+                if (expected[i] % 10 == 0)
+                    expected.push_back(FOLLOW_UP + expected[i]);
+            }
+
+            events.processEvents();
+
+            CHECK(firstBatch == expected);
+            CHECK(secondBatch == expected);
+            CHECK(perEvent == expected);
+            CHECK(other == expectedOther);
+            // pierwsza partia to cała kolejka klatki, druga - zdarzenia dokolejkowane przez listener
+            CHECK(batchSizes.size() == 2);
+            CHECK(!batchSizes.empty() && batchSizes[0] == queuedCount);
+        }
+
+        // triggerEvent - partia z jednym zdarzeniem, od razu
+        firstBatch.clear();
+        batchSizes.clear();
+        NumberEvent immediate;
+        immediate.value = 7;
+        events.triggerEvent(immediate);
+        CHECK(firstBatch == std::vector<uint32_t>{ 7 });
+        CHECK(batchSizes == std::vector<size_t>{ 1 });
+    }
+
+    // listener dodający listenery w trakcie processEvents - tablica wpisów nie może się wtedy realokować
+    // (wykonywany delegat leży w niej); nowe listenery działają od następnego przejścia listy,
+    // czyli zwykłe od następnego zdarzenia, a wsadowe od następnego processEvents()
+    void testAddDuringDispatch()
+    {
+        struct State {
+            EventSystem events;
+            std::vector<uint32_t> calls;
+            uint32_t lateCalls = 0;
+            uint32_t batchCalls = 0;
+            ListenerHandle removedLate;
+        } state;
+        EventSystem& events = state.events;
+
+        // stan w buforze delegata - po realokacji tablicy wpisów czytany byłby ze zwolnionej pamięci
+        uint32_t marker = 0xC0FFEE;
+        auto handle = events.registerListener<NumberEvent>([&state, marker](const Event& event)
+            {
+                uint32_t value = static_cast<const NumberEvent&>(event).value;
+                if (value == 0)
+                {
+                    for (int i = 0; i < 64; i++)
+                    {
+                        state.events.registerListener<NumberEvent>([&state](const Event&) { state.lateCalls++; });
+                    }
+                    // usunięcie listenera, który jeszcze czeka na dołączenie
+                    state.removedLate = state.events.registerListener<NumberEvent>([&state](const Event&) { state.lateCalls += 1000; });
+                    CHECK(state.events.unregisterListener(state.removedLate));
+                }
+                state.calls.push_back(marker == 0xC0FFEE ? value : ~0u);
+            });
+        events.registerBatchListener<NumberEvent>([&state](std::span<const NumberEvent> batch)
+            {
+                if (state.batchCalls++ > 0)
+                    return;
+                CHECK(batch.size() == 3);
+                for (int i = 0; i < 16; i++)
+                {
+                    state.events.registerBatchListener<NumberEvent>([&state](std::span<const NumberEvent> late)
+                        {
+                            state.lateCalls += static_cast<uint32_t>(late.size()) * 100;
+                        });
+                }
+            });
+
+        for (uint32_t value = 0; value < 3; value++)
+        {
+            NumberEvent event;
+            event.value = value;
+            events.queueEvent(event);
+        }
+        events.processEvents();
+        CHECK(state.calls == std::vector<uint32_t>({ 0, 1, 2 }));
+        // 64 nowe zwykłe dla zdarzeń 1 i 2
+        CHECK(state.lateCalls == 64 * 2);
+        CHECK(state.batchCalls == 1);
+
+        NumberEvent event;
+        event.value = 3;
+        events.queueEvent(event);
+        events.processEvents();
+        CHECK(state.calls == std::vector<uint32_t>({ 0, 1, 2, 3 }));
+        // do tego 64 zwykłe i 16 wsadowych po 100 dla jednego zdarzenia
+        CHECK(state.lateCalls == 64 * 3 + 16 * 100);
+        CHECK(events.unregisterListener(handle));
+    }
+
+    // wątki dochodzą i kończą się jak przy restarcie workerów - łącznie dużo więcej niż MAX_EVENT_THREADS
+    void testSlotsAreRecycled()
+    {
+        EventSystem events;
+        std::vector<uint32_t> received;
+        auto handle = events.registerListener<NumberEvent>([&](const Event& event)
+            {
+                received.push_back(static_cast<const NumberEvent&>(event).value);
+            });
+
+        constexpr uint32_t ROUNDS = detail::MAX_EVENT_THREADS * 3;
+        constexpr uint32_t THREADS_PER_ROUND = 8;
+        uint32_t expected = 0;
+        for (uint32_t round = 0; round < ROUNDS / THREADS_PER_ROUND; round++)
+        {
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < THREADS_PER_ROUND; t++)
+            {
+                uint32_t value = round * THREADS_PER_ROUND + t;
+                threads.emplace_back([&events, value]()
+                    {
+                        NumberEvent event;
+                        event.value = value;
+                        events.queueEventConcurrent(value, event);
+                    });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            expected += THREADS_PER_ROUND;
+        }
+        events.processEvents();
+
+        CHECK(received.size() == expected);
+        bool ordered = true;
+        for (uint32_t i = 0; i < received.size(); i++)
+        {
+            ordered &= received[i] == i;
+        }
+        CHECK(ordered);
+        events.unregisterListener(handle);
+    }
+
+    // kolejność według klucza, przy równym kluczu - według wysłania; nie zależy od przeplotu wątków
+    void testMergeOrder()
+    {
+        constexpr uint32_t PRODUCERS = 6;
+        constexpr uint32_t EVENTS_PER_PRODUCER = 2000;
+
+        EventSystem events;
+        std::vector<NumberEvent> received;
+        events.registerBatchListener<NumberEvent>([&](std::span<const NumberEvent> batch)
+            {
+                received.insert(received.end(), batch.begin(), batch.end());
+            });
+
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+            received.clear();
+            std::vector<std::thread> threads;
+            for (uint32_t producer = 0; producer < PRODUCERS; producer++)
+            {
+                threads.emplace_back([&events, producer]()
+                    {
+                        for (uint32_t i = 0; i < EVENTS_PER_PRODUCER; i++)
+                        {
+                            NumberEvent event;
+                            event.producer = producer;
+                            event.value = i;
+                            // dwa zdarzenia na klucz - producent jest częścią klucza, więc równe klucze są z jednego wątku
+                            events.queueEventConcurrent((uint64_t(i / 2) << 8) | producer, event);
+                        }
+                    });
+            }
+            for (auto& thread : threads)
+            {
+                thread.join();
+            }
+            events.processEvents();
+
+            CHECK(received.size() == PRODUCERS * EVENTS_PER_PRODUCER);
+            bool ordered = true;
+            for (uint32_t k = 0; k < received.size(); k++)
+            {
+                uint32_t pair = k / (2 * PRODUCERS);
+                uint32_t producer = (k / 2) % PRODUCERS;
+                ordered &= received[k].producer == producer && received[k].value == pair * 2 + k % 2;
+            }
+            CHECK(ordered);
+        }
+    }
+
+    std::vector<CollisionEvent> collisionEvents(uint32_t threads)
+    {
+        JobSystem::GetInstance().setThreadCount(threads);
+
+        Scene scene(nullptr);
+        auto& ts = scene.getTransformSystem();
+        for (int i = 0; i < 40; i++)
+        {
+            EntityID id = scene.createEntity();
+            scene.addComponent<ColliderComponent>(id, ColliderComponent(i % 3 == 0 ? ColliderType::SPHERE : ColliderType::BOX));
+            ts.translateEntity(id, glm::vec3(i * 0.4f, (i % 5) * 0.3f, 0.0f));
+        }
+        ts.update();
+
+        std::vector<CollisionEvent> received;
+        scene.getEventSystem().registerBatchListener<CollisionEvent>([&](std::span<const CollisionEvent> batch)
+            {
+                received.insert(received.end(), batch.begin(), batch.end());
+            });
+
+        auto& collisionSystem = scene.getCollisionSystem();
+        collisionSystem.CheckCollisions();
+        scene.getEventSystem().processEvents();
+
+        // zdarzenia w kolejności GetCollisions, każde zaraz po nim zamienione (B, A)
+        const auto& collisions = collisionSystem.GetCollisions();
+        CHECK(!collisions.empty());
+        CHECK(received.size() == collisions.size() * 2);
+        bool matches = received.size() == collisions.size() * 2;
+        for (size_t i = 0; matches && i < collisions.size(); i++)
+        {
+            matches &= received[2 * i].objectA == collisions[i].objectA && received[2 * i].objectB == collisions[i].objectB;
+            matches &= received[2 * i + 1].objectA == collisions[i].objectB && received[2 * i + 1].objectB == collisions[i].objectA;
+            matches &= received[2 * i + 1].separationVector == -collisions[i].separationVector;
+        }
+        CHECK(matches);
+        return received;
+    }
+
+    // CollisionSystem wysyła zdarzenia z zadań parallelFor - wynik taki sam przy 1 i wielu wątkach
+    void testCollisionEventsFromWorkers()
+    {
+        auto serial = collisionEvents(1);
+        for (uint32_t threads : { 2u, 4u, 8u })
+        {
+            auto parallel = collisionEvents(threads);
+            bool same = parallel.size() == serial.size();
+            for (size_t i = 0; same && i < serial.size(); i++)
+            {
+                same &= parallel[i].objectA == serial[i].objectA && parallel[i].objectB == serial[i].objectB &&
+                    parallel[i].separationVector == serial[i].separationVector;
+            }
+            CHECK(same);
+        }
+    }
+
+}
+
+int main()
+{
+    testBatchListenersReceiveEveryEvent();
+    testAddDuringDispatch();
+    testSlotsAreRecycled();
+    testMergeOrder();
+    testCollisionEventsFromWorkers();
+    return TestCheck::finish();
+}
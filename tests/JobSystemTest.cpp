@@ -0,0 +1,160 @@
+// JobSystem: wait() wykonuje zadania na wątku czekającym, runAfter startuje po zależności,
+// parallelFor odwiedza każdy indeks dokładnie raz - przy 1, 2, 4 i 8 wątkach.
+
+#include "TestCheck.h"
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    // bez wątków roboczych wszystko musi wykonać wait() na wątku wołającym
+    void testWaitRunsJobs()
+    {
+        JobSystem& jobSystem = JobSystem::GetInstance();
+        jobSystem.setThreadCount(1);
+
+        std::thread::id caller = std::this_thread::get_id();
+        std::atomic<uint32_t> ran{ 0 };
+        std::atomic<uint32_t> onCaller{ 0 };
+        JobCounter counter;
+        for (int i = 0; i < 100; i++)
+        {
+            jobSystem.run([&]()
+                {
+                    ran++;
+                    if (std::this_thread::get_id() == caller)
+                        onCaller++;
+                }, counter);
+        }
+        CHECK(ran == 0);
+        CHECK(!counter.isDone());
+
+        jobSystem.wait(counter);
+        CHECK(counter.isDone());
+        CHECK(ran == 100);
+        CHECK(onCaller == 100);
+    }
+
+    // zadanie czekające na własne podzadania nie blokuje wątku - wait() wykonuje je w międzyczasie
+    void testNestedWait(uint32_t threads)
+    {
+        JobSystem& jobSystem = JobSystem::GetInstance();
+        jobSystem.setThreadCount(threads);
+
+        std::atomic<uint32_t> leaves{ 0 };
+        JobCounter outer;
+        for (int i = 0; i < 16; i++)
+        {
+            jobSystem.run([&]()
+                {
+                    JobCounter inner;
+                    for (int k = 0; k < 16; k++)
+                    {
+                        jobSystem.run([&]() { leaves++; }, inner);
+                    }
+                    jobSystem.wait(inner);
+                }, outer);
+        }
+        jobSystem.wait(outer);
+        CHECK(leaves == 16 * 16);
+    }
+
+    // łańcuch etapów: każdy etap widzi komplet wyników poprzedniego
+    void testRunAfterOrdering(uint32_t threads)
+    {
+        JobSystem& jobSystem = JobSystem::GetInstance();
+        jobSystem.setThreadCount(threads);
+
+        constexpr uint32_t STAGES = 6;
+        constexpr uint32_t JOBS_PER_STAGE = 32;
+        std::vector<std::unique_ptr<JobCounter>> counters;
+        for (uint32_t stage = 0; stage < STAGES; stage++)
+        {
+            counters.push_back(std::make_unique<JobCounter>());
+        }
+
+        std::atomic<uint32_t> finished[STAGES] = {};
+        std::atomic<uint32_t> violations{ 0 };
+        for (uint32_t stage = 0; stage < STAGES; stage++)
+        {
+            for (uint32_t job = 0; job < JOBS_PER_STAGE; job++)
+            {
+                auto body = [&, stage]()
+                    {
+                        if (stage > 0 && finished[stage - 1].load() != JOBS_PER_STAGE)
+                            violations++;
+                        finished[stage]++;
+                    };
+                if (stage == 0)
+                    jobSystem.run(body, *counters[0]);
+                else
+                    jobSystem.runAfter(*counters[stage - 1], body, *counters[stage]);
+            }
+        }
+        jobSystem.wait(*counters.back());
+
+        CHECK(violations == 0);
+        for (uint32_t stage = 0; stage < STAGES; stage++)
+        {
+            CHECK(finished[stage] == JOBS_PER_STAGE);
+            CHECK(counters[stage]->isDone());
+        }
+
+        // zależność już spełniona - zadanie trafia od razu do kolejki
+        bool ran = false;
+        JobCounter late;
+        jobSystem.runAfter(*counters[0], [&]() { ran = true; }, late);
+        jobSystem.wait(late);
+        CHECK(ran);
+    }
+
+    void testParallelForCoversEveryIndex(uint32_t threads)
+    {
+        JobSystem& jobSystem = JobSystem::GetInstance();
+        jobSystem.setThreadCount(threads);
+
+        for (uint32_t count : { 0u, 1u, 7u, 64u, 1000u, 100003u })
+        {
+            for (uint32_t minBatch : { 1u, 16u, 4096u })
+            {
+                std::vector<std::atomic<uint32_t>> hits(count);
+                std::atomic<bool> badRange{ false };
+                jobSystem.parallelFor(count, minBatch, [&](uint32_t begin, uint32_t end)
+                    {
+                        if (begin >= end || end > count)
+                            badRange = true;
+                        for (uint32_t i = begin; i < end; i++)
+                        {
+                            hits[i].fetch_add(1, std::memory_order_relaxed);
+                        }
+                    });
+
+                bool exactlyOnce = true;
+                for (auto& hit : hits)
+                {
+                    exactlyOnce &= hit.load() == 1;
+                }
+                CHECK(!badRange);
+                CHECK(exactlyOnce);
+            }
+        }
+    }
+
+}
+
+int main()
+{
+    testWaitRunsJobs();
+    for (uint32_t threads : { 1u, 2u, 4u, 8u })
+    {
+        testNestedWait(threads);
+        testRunAfterOrdering(threads);
+        testParallelForCoversEveryIndex(threads);
+    }
+    return TestCheck::finish();
+}
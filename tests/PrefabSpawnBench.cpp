@@ -0,0 +1,90 @@
+// Koszt jednej instancji prefabu: PrefabTemplate::instantiate kontra dawna ścieżka
+// (kopia JSON-a prefabu + Serialization::deserializeObjects przy każdym spawnie).
+// Prefaby: Trail z res/prefabs.json (1 encja) i TestSupport::createTestPrefab (16 encji z referencjami).
+// Użycie: PrefabSpawnBench
+
+#include "TestSupport.h"
+
+#include "PrefabTemplate.h"
+#include "Scene.h"
+#include "Serialization.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+using json = nlohmann::json;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // mikrosekundy na spawn, najlepsze z 3 powtórzeń; każde powtórzenie w nowej scenie
+    double measure(const char* what, int spawns, const std::function<void(Scene&)>& spawn)
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+            Scene scene(nullptr);
+            auto start = Clock::now();
+            for (int i = 0; i < spawns; i++)
+            {
+                spawn(scene);
+            }
+            best = std::min(best, std::chrono::duration<double, std::micro>(Clock::now() - start).count() / spawns);
+        }
+        std::printf("  %-34s %8.2f us/spawn\n", what, best);
+        return best;
+    }
+
+}
+
+int main()
+{
+    std::vector<Shader*> shaders{ TestSupport::createShader("CelShading") };
+    std::vector<Model*> models{ TestSupport::createModel("res/models/MASLO.fbx") };
+    Serialization::GlobalDeserializationContext context{ shaders, models, false };
+
+    json prefabList;
+    std::ifstream(ENGINE_RES_DIR "/prefabs.json") >> prefabList;
+    json trail = prefabList["prefabs"][0]["data"];
+    json synthetic = TestSupport::createTestPrefab(context);
+
+    std::printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    for (const json* prefabJson : { &trail, &synthetic })
+    {
+        auto compileStart = Clock::now();
+        PrefabTemplate prefab = PrefabTemplate::compile(*prefabJson, context);
+        double compileMicroseconds = std::chrono::duration<double, std::micro>(Clock::now() - compileStart).count();
+
+        size_t entityCount = (*prefabJson)["entities"].size();
+        std::printf("%s prefab, %zu entities (compile once: %.1f us)\n",
+            prefabJson == &trail ? "Trail" : "test", entityCount, compileMicroseconds);
+
+        int spawns = prefabJson == &trail ? 5000 : 1000;
+        double fromJson = measure("JSON copy + deserializeObjects", spawns, [&](Scene& scene)
+            {
+                // jak dawne Application::instantiatePrefab - JSON kopiowany przy każdym wywołaniu
+                json prefabData = *prefabJson;
+                Serialization::deserializeObjects(prefabData, scene, scene.getSceneRootEntity(), context);
+            });
+        double fromTemplate = measure("PrefabTemplate::instantiate", spawns, [&](Scene& scene)
+            {
+                prefab.instantiate(scene, scene.getSceneRootEntity());
+            });
+        std::printf("  speedup %.1fx\n", fromJson / fromTemplate);
+    }
+
+    for (Shader* shader : shaders)
+    {
+        delete shader;
+    }
+    for (Model* model : models)
+    {
+        delete model;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+// PrefabTemplate::instantiate daje te same encje i komponenty co Serialization::deserializeObjects
+// z JSON-a prefabu. Obie instancje są serializowane i porównywane komponent po komponencie;
+// uuid (różne w każdej instancji) zamieniane na pozycję encji, więc referencje też są porównane.
+
+#include "TestCheck.h"
+#include "TestSupport.h"
+
+#include "PrefabTemplate.h"
+#include "Scene.h"
+#include "Serialization.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+
+using json = nlohmann::json;
+
+namespace {
+
+    // uuid encji -> "#pozycja"; korzeń sceny (rodzic korzenia prefabu) -> "#sceneRoot"
+    void replaceUuids(json& value, const std::unordered_map<std::string, std::string>& names)
+    {
+        if (value.is_string())
+        {
+            auto it = names.find(value.get<std::string>());
+            if (it != names.end())
+                value = it->second;
+        }
+        else if (value.is_structured())
+        {
+            for (auto& item : value)
+            {
+                replaceUuids(item, names);
+            }
+        }
+    }
+
+    json serializeInstance(const Scene& scene, EntityID root)
+    {
+        json instance = Serialization::serializeObjects({ root }, scene)["entities"];
+
+        std::unordered_map<std::string, std::string> names;
+        names[scene.getComponent<ObjectInfoComponent>(scene.getSceneRootEntity()).uuid] = "#sceneRoot";
+        for (size_t i = 0; i < instance.size(); i++)
+        {
+            names[instance[i]["ObjectInfoComponent"]["uuid"].get<std::string>()] = "#" + std::to_string(i);
+        }
+        replaceUuids(instance, names);
+        return instance;
+    }
+
+    void compareInstances(const char* prefabName, const json& prefabJson, const Serialization::GlobalDeserializationContext& context)
+    {
+        // różna liczba encji przed instancją - identyfikatory encji w obu scenach się nie pokrywają
+        Scene fromJson(nullptr);
+        for (int i = 0; i < 3; i++)
+        {
+            fromJson.createEntity();
+        }
+        EntityID jsonRoot = Serialization::deserializeObjects(prefabJson, fromJson, fromJson.getSceneRootEntity(), context)[0];
+
+        PrefabTemplate prefab = PrefabTemplate::compile(prefabJson, context);
+        Scene fromTemplate(nullptr);
+        for (int i = 0; i < 7; i++)
+        {
+            fromTemplate.createEntity();
+        }
+        std::vector<EntityID> instance = prefab.instantiate(fromTemplate, fromTemplate.getSceneRootEntity());
+        CHECK(!instance.empty());
+        if (instance.empty())
+            return;
+
+        json expected = serializeInstance(fromJson, jsonRoot);
+        json actual = serializeInstance(fromTemplate, instance[0]);
+        CHECK(actual.size() == expected.size());
+        CHECK(instance.size() == expected.size());
+
+        for (size_t entity = 0; entity < std::min(actual.size(), expected.size()); entity++)
+        {
+            // każdy komponent osobno - w razie różnicy wiadomo, który
+            for (const auto& [component, value] : expected[entity].items())
+            {
+                bool same = actual[entity].contains(component) && actual[entity][component] == value;
+                if (!same)
+                    std::printf("%s: entity %zu, %s differs\n", prefabName, entity, component.c_str());
+                CHECK(same);
+            }
+            for (const auto& [component, value] : actual[entity].items())
+            {
+                bool expectedHasIt = expected[entity].contains(component);
+                if (!expectedHasIt)
+                    std::printf("%s: entity %zu, unexpected %s\n", prefabName, entity, component.c_str());
+                CHECK(expectedHasIt);
+            }
+        }
+
+        // kształt collidera nie jest współdzielony między instancjami (shared_ptr w komponencie)
+        std::vector<EntityID> second = prefab.instantiate(fromTemplate, fromTemplate.getSceneRootEntity());
+        for (size_t i = 0; i < instance.size() && i < second.size(); i++)
+        {
+            if (fromTemplate.hasComponent<ColliderComponent>(instance[i]))
+                CHECK(fromTemplate.getComponent<ColliderComponent>(instance[i]).GetColliderShape() !=
+                    fromTemplate.getComponent<ColliderComponent>(second[i]).GetColliderShape());
+        }
+    }
+
+}
+
+int main()
+{
+    std::vector<Shader*> shaders{ TestSupport::createShader("CelShading") };
+    std::vector<Model*> models{ TestSupport::createModel("res/models/MASLO.fbx") };
+    Serialization::GlobalDeserializationContext context{ shaders, models, false };
+
+    // prefaby gry
+    json prefabList;
+    std::ifstream(ENGINE_RES_DIR "/prefabs.json") >> prefabList;
+    CHECK(prefabList.contains("prefabs"));
+    for (const auto& prefab : prefabList["prefabs"])
+    {
+        compareInstances(prefab["name"].get<std::string>().c_str(), prefab["data"], context);
+    }
+
+    compareInstances("TestPrefab", TestSupport::createTestPrefab(context), context);
+
+    for (Shader* shader : shaders)
+    {
+        delete shader;
+    }
+    for (Model* model : models)
+    {
+        delete model;
+    }
+    return TestCheck::finish();
+}
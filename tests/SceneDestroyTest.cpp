@@ -0,0 +1,134 @@
+// Scene::destroyEntities: usuwa całe poddrzewa (także gdy podano rodzica i jego potomka, powtórzenia
+// i martwe ID), poprawia listy dzieci rodziców spoza zbioru i zdejmuje komponenty i indeksy.
+
+#include "TestCheck.h"
+
+#include "Scene.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    const std::vector<EntityID>& childrenOf(const Scene& scene, EntityID id)
+    {
+        return scene.getComponent<TransformInfoComponent>(id).children;
+    }
+
+    void testSubtreeBatch()
+    {
+        Scene scene(nullptr);
+        EntityID root = scene.getSceneRootEntity();
+
+        //   root
+        //   ├─ a ─┬─ b ── c
+        //   │     └─ d
+        //   ├─ e ─┬─ f
+        //   │     └─ g ── h
+        //   └─ i
+        EntityID a = scene.createEntity(root);
+        EntityID b = scene.createEntity(a);
+        EntityID c = scene.createEntity(b);
+        EntityID d = scene.createEntity(a);
+        EntityID e = scene.createEntity(root);
+        EntityID f = scene.createEntity(e);
+        EntityID g = scene.createEntity(e);
+        EntityID h = scene.createEntity(g);
+        EntityID i = scene.createEntity(root);
+        scene.addComponent<VelocityComponent>(c, VelocityComponent{});
+        scene.addComponent<VelocityComponent>(f, VelocityComponent{});
+        scene.setEntityName(c, "c");
+        scene.setEntityTag(h, "doomed");
+
+        // potomek przed rodzicem, powtórzenie, dziecko z innego poddrzewa, ID spoza sceny
+        EntityID batch[] = { c, a, b, c, g, (EntityID)12345 };
+        scene.destroyEntities(batch);
+
+        for (EntityID id : { a, b, c, d, g, h })
+        {
+            CHECK(!scene.hasEntity(id));
+            CHECK(!scene.hasComponent<Transform>(id));
+            CHECK(!scene.hasComponent<TransformInfoComponent>(id));
+        }
+        for (EntityID id : { e, f, i })
+        {
+            CHECK(scene.hasEntity(id));
+        }
+        CHECK(!scene.hasComponent<VelocityComponent>(c));
+        CHECK(scene.hasComponent<VelocityComponent>(f));
+        CHECK(scene.findEntitiesByName("c").empty());
+        CHECK(scene.findEntitiesByTag("doomed").empty());
+
+        // listy dzieci rodziców spoza zbioru - bez usuniętych, kolejność pozostałych zachowana
+        CHECK(childrenOf(scene, root) == std::vector<EntityID>({ e, i }));
+        CHECK(childrenOf(scene, e) == std::vector<EntityID>({ f }));
+        CHECK(scene.getEntities().size() == 4);
+
+        // kolejne wywołanie na tych samych buforach
+        EntityID j = scene.createEntity(f);
+        EntityID k = scene.createEntity(f);
+        EntityID single[] = { j };
+        scene.destroyEntities(single);
+        CHECK(childrenOf(scene, f) == std::vector<EntityID>({ k }));
+
+        // nieaktualne ID (indeks użyty ponownie przez nową encję) nie usuwa nowej encji
+        EntityID reused = scene.createEntity(i);
+        EntityID stale[] = { j };
+        scene.destroyEntities(stale);
+        CHECK(scene.hasEntity(reused));
+        CHECK(childrenOf(scene, i) == std::vector<EntityID>({ reused }));
+
+        EntityID none[] = { a };
+        scene.destroyEntities(none);
+        CHECK(scene.getEntities().size() == 6);
+    }
+
+    // losowe drzewo, losowe partie - wynik jak przy usuwaniu encji pojedynczo
+    void testMatchesOneByOne()
+    {
+        for (uint32_t seed = 1; seed <= 20; seed++)
+        {
+            Scene batchScene(nullptr);
+            Scene singleScene(nullptr);
+            std::vector<EntityID> ids{ batchScene.getSceneRootEntity() };
+            uint32_t state = seed;
+            auto next = [&state]() { state = state * 1664525u + 1013904223u; return state >> 8; };
+            for (int n = 0; n < 300; n++)
+            {
+                EntityID parent = ids[next() % ids.size()];
+                EntityID id = batchScene.createEntity(parent);
+                CHECK(singleScene.createEntity(parent) == id);
+                ids.push_back(id);
+            }
+
+            std::vector<EntityID> batch;
+            for (int n = 0; n < 25; n++)
+            {
+                batch.push_back(ids[1 + next() % (ids.size() - 1)]);
+            }
+            batchScene.destroyEntities(batch);
+            for (EntityID id : batch)
+            {
+                singleScene.destroyEntity(id);
+            }
+
+            bool same = true;
+            for (EntityID id : ids)
+            {
+                same &= batchScene.hasEntity(id) == singleScene.hasEntity(id);
+                if (batchScene.hasEntity(id) && singleScene.hasEntity(id))
+                    same &= childrenOf(batchScene, id) == childrenOf(singleScene, id);
+            }
+            CHECK(same);
+        }
+    }
+
+}
+
+int main()
+{
+    testSubtreeBatch();
+    testMatchesOneByOne();
+    return TestCheck::finish();
+}
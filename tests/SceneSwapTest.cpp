@@ -0,0 +1,146 @@
+// Systemy rejestrowane raz, scena podmieniana jak w Application::loadScene i trybie Play/Stop edytora.
+// Kolejki zapisów muszą być brane z bieżącej sceny - stara jest już zwolniona.
+// Scene::restoreFrom (Stop w edytorze) zachowuje listenery i odrzuca zdarzenia sprzed przywrócenia.
+
+#include "TestCheck.h"
+
+#include "JobSystem.h"
+#include "Scene.h"
+#include "ECS/SystemScheduler.h"
+
+#include <memory>
+
+namespace {
+
+    std::shared_ptr<Scene> scene;
+
+    EntityID spawnMover(Scene& target, const glm::vec3& velocity)
+    {
+        EntityID id = target.createEntity();
+        VelocityComponent velocityComponent;
+        velocityComponent.velocity = velocity;
+        velocityComponent.useGravity = false;
+        target.addComponent<VelocityComponent>(id, velocityComponent);
+        return id;
+    }
+
+    // jak setupSystems: dwa systemy czytające Transform (mogą iść równolegle) i jedyny zapisujący
+    void setupSystems(SystemScheduler& scheduler)
+    {
+        uint32_t nextWriteQueue = 0;
+        for (const char* name : { "MoverA", "MoverB" })
+        {
+            scheduler.addSystem({
+                .name = name,
+                .access = SystemAccess().read<Transform>().write<VelocityComponent>(),
+                .update = [writeQueue = nextWriteQueue++]()
+                {
+                    auto& transformWrites = scene->getTransformSystem().getWriteQueue(writeQueue);
+                    scene->view<VelocityComponent, Transform>().each([&](EntityID id, VelocityComponent& velocity, const Transform& transform)
+                        {
+                            // każdy system rusza tylko "swoje" encje - wybór po znaku prędkości
+                            if ((velocity.velocity.x > 0.0f) == (writeQueue == 0))
+                                transformWrites.translate(id, transform.translation + velocity.velocity);
+                        });
+                },
+            });
+        }
+        scheduler.addSystem({
+            .name = "TransformUpdate",
+            .access = SystemAccess().write<Transform, TransformInfoComponent>(),
+            .update = []()
+            {
+                scene->getTransformSystem().update();
+            },
+        });
+    }
+
+    glm::vec3 globalPosition(const Scene& target, EntityID id)
+    {
+        return glm::vec3(target.getComponent<Transform>(id).globalMatrix[3]);
+    }
+
+}
+
+int main()
+{
+    JobSystem::GetInstance().setThreadCount(4);
+
+    SystemScheduler scheduler;
+    scene = std::make_shared<Scene>(nullptr);
+    setupSystems(scheduler);
+
+    EntityID first = spawnMover(*scene, { 1.0f, 0.0f, 0.0f });
+    scheduler.run(*scene);
+    CHECK(globalPosition(*scene, first) == glm::vec3(1.0f, 0.0f, 0.0f));
+
+    // loadScene: nowa scena, stara zwolniona
+    scene = std::make_shared<Scene>(nullptr);
+    EntityID right = spawnMover(*scene, { 2.0f, 0.0f, 0.0f });
+    EntityID left = spawnMover(*scene, { -3.0f, 0.0f, 0.0f });
+    for (int frame = 0; frame < 3; frame++)
+    {
+        scheduler.run(*scene);
+    }
+    CHECK(globalPosition(*scene, right) == glm::vec3(6.0f, 0.0f, 0.0f));
+    CHECK(globalPosition(*scene, left) == glm::vec3(-9.0f, 0.0f, 0.0f));
+
+    // Stop w edytorze: kopia kopii zapasowej; kopia nie dzieli kolejek z oryginałem
+    auto backup = std::make_shared<Scene>(*scene);
+    scheduler.run(*scene);
+    scene = std::make_shared<Scene>(*backup);
+    scheduler.run(*scene);
+    CHECK(globalPosition(*scene, right) == glm::vec3(8.0f, 0.0f, 0.0f));
+    CHECK(globalPosition(*backup, right) == glm::vec3(6.0f, 0.0f, 0.0f));
+
+    // zapis odłożony w scenie, która potem znika, nie trafia do następnej
+    scene->getTransformSystem().getWriteQueue(0).translate(right, { 100.0f, 0.0f, 0.0f });
+    scene = std::make_shared<Scene>(*backup);
+    scheduler.run(*scene);
+    CHECK(globalPosition(*scene, right) == glm::vec3(8.0f, 0.0f, 0.0f));
+
+    // Stop w edytorze: restoreFrom - ta sama scena, listenery zarejestrowane raz (jak setupEvents) zostają
+    struct PingEvent : Event {};
+    int pings = 0;
+    int contacts = 0;
+    scene->getEventSystem().registerListener<PingEvent>([&](const Event&) { pings++; });
+    scene->getCollisionSystem().onCollision<ColliderComponent>([&](const CollisionEvent& event)
+        {
+            if (event.isColliding)
+                contacts++;
+        });
+    EntityID boxA = scene->createEntity();
+    EntityID boxB = scene->createEntity();
+    scene->addComponent<ColliderComponent>(boxA, ColliderComponent(ColliderType::BOX));
+    scene->addComponent<ColliderComponent>(boxB, ColliderComponent(ColliderType::BOX));
+    scene->getTransformSystem().update();
+
+    Scene* sameScene = scene.get();
+    backup = std::make_shared<Scene>(*scene);
+    scheduler.run(*scene);
+    scene->getTransformSystem().getWriteQueue(0).translate(right, { 100.0f, 0.0f, 0.0f });
+    scene->getEventSystem().queueEvent(PingEvent{});
+    scene->getCollisionSystem().CheckCollisions();
+    scene->restoreFrom(*backup);
+    CHECK(scene.get() == sameScene);
+    CHECK(scene->getCollisionSystem().GetCollisions().empty());
+
+    // zdarzenia i zapisy sprzed przywrócenia odrzucone
+    scene->getEventSystem().processEvents();
+    CHECK(pings == 0);
+    CHECK(contacts == 0);
+    CHECK(globalPosition(*scene, right) == glm::vec3(8.0f, 0.0f, 0.0f));
+
+    scheduler.run(*scene);
+    CHECK(globalPosition(*scene, right) == glm::vec3(10.0f, 0.0f, 0.0f));
+    CHECK(globalPosition(*backup, right) == glm::vec3(8.0f, 0.0f, 0.0f));
+
+    scene->getEventSystem().queueEvent(PingEvent{});
+    scene->getCollisionSystem().CheckCollisions();
+    scene->getEventSystem().processEvents();
+    CHECK(pings == 1);
+    CHECK(contacts == 2);
+
+    scene = nullptr;
+    return TestCheck::finish();
+}
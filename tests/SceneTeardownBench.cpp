@@ -0,0 +1,86 @@
+// Koszt Scene::destroyEntity: usunięcie całego poddrzewa (płaskiego i o rozgałęzieniu 8) oraz
+// pojedyncze usunięcia liści w dużej scenie - koszt jednego wywołania nie może zależeć od liczby encji w scenie.
+// Encje mają Transform, VelocityComponent i co druga ColliderComponent; obok zostaje 5000 innych encji.
+// Użycie: SceneTeardownBench
+
+#include "Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // drzewo o zadanym rozgałęzieniu, zwraca encje w kolejności tworzenia (korzeń pierwszy)
+    std::vector<EntityID> buildTree(Scene& scene, int count, int fanout)
+    {
+        std::vector<EntityID> ids;
+        ids.push_back(scene.createEntity(scene.getSceneRootEntity()));
+        for (int i = 1; i < count; i++)
+        {
+            EntityID id = scene.createEntity(ids[(i - 1) / fanout]);
+            scene.addComponent<VelocityComponent>(id, VelocityComponent{});
+            if (i % 2)
+                scene.addComponent<ColliderComponent>(id, ColliderComponent(ColliderType::BOX));
+            ids.push_back(id);
+        }
+        return ids;
+    }
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+}
+
+int main()
+{
+    std::printf("hardware threads: %u, best of 3\n", std::thread::hardware_concurrency());
+
+    struct Case {
+        int count;
+        int fanout;
+        const char* name;
+    };
+    const Case subtrees[] = { { 1000, 1000, "1k flat" }, { 1000, 8, "1k fanout 8" }, { 10000, 10000, "10k flat" },
+        { 10000, 8, "10k fanout 8" }, { 20000, 8, "20k fanout 8" } };
+    for (const Case& subtree : subtrees)
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+            Scene scene(nullptr);
+            buildTree(scene, 5000, 16);
+            EntityID root = buildTree(scene, subtree.count, subtree.fanout)[0];
+            auto start = Clock::now();
+            scene.destroyEntity(root);
+            best = std::min(best, millisecondsSince(start));
+        }
+        std::printf("subtree %-14s %9.2f ms  (%.0f ns/entity)\n", subtree.name, best, best * 1e6 / subtree.count);
+    }
+
+    // pojedyncze liście w scenach różnej wielkości
+    constexpr int LEAVES = 1000;
+    for (int sceneSize : { 10000, 100000 })
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < 3; repeat++)
+        {
+            Scene scene(nullptr);
+            std::vector<EntityID> ids = buildTree(scene, sceneSize, 8);
+            auto start = Clock::now();
+            for (int i = 0; i < LEAVES; i++)
+            {
+                scene.destroyEntity(ids[ids.size() - 1 - i]);
+            }
+            best = std::min(best, millisecondsSince(start));
+        }
+        std::printf("single leaf, %6d-entity scene %9.2f us/call\n", sceneSize, best * 1e3 / LEAVES);
+    }
+    return 0;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+// Sprawdzenia bez frameworka: CHECK zapisuje błąd i leci dalej, main zwraca TestCheck::finish()
+
+#include <cstdio>
+
+namespace TestCheck {
+
+    inline int failures = 0;
+
+    inline void check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (condition)
+            return;
+        failures++;
+        std::printf("FAIL %s:%d: %s\n", file, line, expression);
+    }
+
+    inline int finish()
+    {
+        if (failures > 0)
+        {
+            std::printf("%d checks failed\n", failures);
+            return 1;
+        }
+        std::printf("all checks passed\n");
+        return 0;
+    }
+
+}
+
+#define CHECK(condition) TestCheck::check((condition), #condition, __FILE__, __LINE__)
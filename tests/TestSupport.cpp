@@ -0,0 +1,112 @@
+// Definicje części silnika wymagających okna i kontekstu OpenGL. Testy tworzą Scene(nullptr)
+// i nie renderują, więc rejestr prefabów z Application i RenderingSystem nie są tu potrzebne,
+// a Model i Shader powstają bez plików i kontekstu (TestSupport.h).
+
+#include "TestSupport.h"
+
+#include "Application.h"
+#include "Model.h"
+#include "Scene.h"
+#include "Shader.h"
+#include "ECS/RenderingSystem.h"
+
+#include <cassert>
+
+const PrefabTemplate* Application::findPrefab(const std::string&) const
+{
+	return nullptr;
+}
+
+std::vector<EntityID> Application::instantiatePrefab(const std::string&, Scene&, EntityID)
+{
+	assert(false && "TestSupport: tests run without Application");
+	return {};
+}
+
+RenderingSystem::RenderingSystem(Scene* scene) : scene(scene)
+{
+}
+
+Model::Model()
+{
+}
+
+namespace {
+
+	GLuint APIENTRY stubCreateProgram()
+	{
+		return 1;
+	}
+
+	void APIENTRY stubProgram(GLuint)
+	{
+	}
+
+	// GL_LINK_STATUS - sukces, GL_ACTIVE_UNIFORMS - brak uniformów
+	void APIENTRY stubGetProgramiv(GLuint, GLenum name, GLint* value)
+	{
+		*value = name == GL_LINK_STATUS ? GL_TRUE : 0;
+	}
+
+}
+
+Shader* TestSupport::createShader(const std::string& name)
+{
+	glad_glCreateProgram = stubCreateProgram;
+	glad_glLinkProgram = stubProgram;
+	glad_glDeleteProgram = stubProgram;
+	glad_glGetProgramiv = stubGetProgramiv;
+	return new Shader(name, {});
+}
+
+Model* TestSupport::createModel(const std::string& path)
+{
+	Model* model = new Model();
+	model->path = path;
+	return model;
+}
+
+nlohmann::json TestSupport::createTestPrefab(const Serialization::GlobalDeserializationContext& context)
+{
+	Scene staging(nullptr);
+	auto& transformSystem = staging.getTransformSystem();
+
+	EntityID root = staging.createEntity();
+	staging.setEntityName(root, "TestPrefab");
+	staging.setEntityTag(root, "prefab");
+	transformSystem.translateEntity(root, { 1.0f, 2.0f, 3.0f });
+	transformSystem.rotateEntity(root, glm::vec3(0.0f, 45.0f, 10.0f));
+	staging.addComponent<ModelComponent>(root, ModelComponent{ .shader = context.shaders[0], .model = context.models[0], .color = { 0.5f, 1.0f, 0.25f } });
+	staging.addComponent<ColliderComponent>(root, ColliderComponent(ColliderType::BOX));
+	staging.addComponent<VelocityComponent>(root, VelocityComponent{ .velocity = { 0.0f, 1.0f, 0.0f } });
+	staging.addComponent<ButterHealthComponent>(root, ButterHealthComponent{ .secondsToDie = 3.0f, .startScale = glm::vec3(1.0f) });
+
+	std::vector<EntityID> children;
+	for (int i = 0; i < 15; i++)
+	{
+		EntityID parent = i < 5 ? root : children[i % 5];
+		EntityID child = staging.createEntity(parent);
+		staging.setEntityName(child, "Part" + std::to_string(i));
+		transformSystem.translateEntity(child, { float(i), 0.5f * i, -1.0f });
+		transformSystem.scaleEntity(child, glm::vec3(1.0f + 0.1f * i));
+		staging.addComponent<ColliderComponent>(child, ColliderComponent(i % 2 ? ColliderType::SPHERE : ColliderType::BOX, i % 3 == 0));
+		children.push_back(child);
+	}
+
+	// referencje między encjami prefabu - w instancji muszą wskazywać na jej własne encje
+	ElevatorComponent elevator{};
+	elevator.openHeight = 2.0f;
+	elevator.speed = 1.5f;
+	elevator.buttonEntity = children[1];
+	staging.addComponent<ElevatorComponent>(children[0], elevator);
+	ButtonComponent button{};
+	button.playerTag = "player";
+	button.elevatorEntity = children[0];
+	staging.addComponent<ButtonComponent>(children[1], button);
+	FlyAIComponent flyAI{};
+	flyAI.idButter = children[7];
+	staging.addComponent<FlyAIComponent>(children[6], flyAI);
+
+	transformSystem.update();
+	return Serialization::serializeObjects({ root }, staging);
+}
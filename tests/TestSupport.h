@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include <nlohmann/json.hpp>
+
+#include "Serialization.h"
+
+class Model;
+class Shader;
+
+namespace TestSupport {
+
+    // Shader z samą nazwą - funkcje OpenGL, których używa konstruktor, podmienione na zaślepki.
+    // Do kontekstu deserializacji, który wyszukuje shadery po nazwie.
+    Shader* createShader(const std::string& name);
+    // Model bez wczytywania pliku - deserializacja wyszukuje modele po ścieżce
+    Model* createModel(const std::string& path);
+
+    // Prefab w formacie res/prefabs.json: 16 encji na trzech poziomach, model, collidery, prędkość
+    // i komponenty z referencjami do innych encji prefabu (winda i przycisk, FlyAI)
+    nlohmann::json createTestPrefab(const Serialization::GlobalDeserializationContext& context);
+
+}
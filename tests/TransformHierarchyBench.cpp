@@ -0,0 +1,180 @@
+// Płaska hierarchia TransformSystem::update() kontra dawne przejście rekurencyjne od korzenia
+// (updateNodeRecursive: getComponent na węzeł i jego dzieci, formuła glm). Hierarchie głębokie
+// (łańcuchy po 1000 węzłów) i szerokie (rozgałęzienie 32), 10k i 100k węzłów.
+// Wynik update() porównywany z wynikiem przejścia rekurencyjnego - przy różnicy kod wyjścia 1.
+// Użycie: TransformHierarchyBench [liczba wątków JobSystem, domyślnie 1]
+
+#include "JobSystem.h"
+#include "Scene.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    constexpr int REPEATS = 10;
+    constexpr uint32_t CHAIN_LENGTH = 1000;
+    constexpr uint32_t FANOUT = 32;
+
+    enum class Shape { Deep, Wide };
+
+    // dawna ścieżka: węzeł przeliczany zawsze, potem dzieci rekurencyjnie. Macierz rodzica brana
+    // z wyników według indeksu encji - wzorzec jest przez to nieco tańszy niż dawny drugi getComponent.
+    void recursiveUpdate(const Scene& scene, EntityID id, std::vector<glm::mat4>& out)
+    {
+        const auto& transform = scene.getComponent<Transform>(id);
+        if (!transform.isActive)
+            return;
+
+        glm::mat4 matrix(1.0f);
+        if (transform.parent != (EntityID)-1)
+            matrix = out[entityIndex(transform.parent)];
+        matrix = glm::translate(matrix, transform.translation);
+        matrix *= glm::mat4_cast(transform.rotation);
+        matrix = glm::scale(matrix, transform.scale);
+        out[entityIndex(id)] = matrix;
+
+        for (EntityID child : scene.getComponent<TransformInfoComponent>(id).children)
+        {
+            recursiveUpdate(scene, child, out);
+        }
+    }
+
+    std::vector<EntityID> buildHierarchy(Scene& scene, Shape shape, uint32_t nodeCount)
+    {
+        std::mt19937 rng(11);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<EntityID> ids;
+        ids.reserve(nodeCount);
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            EntityID parent = scene.getSceneRootEntity();
+            if (shape == Shape::Deep && i % CHAIN_LENGTH != 0)
+                parent = ids[i - 1];
+            else if (shape == Shape::Wide && i >= FANOUT)
+                parent = ids[i / FANOUT - 1];
+            ids.push_back(scene.createEntity(parent));
+        }
+
+        // małe przesunięcia i obroty - w łańcuchu 1000 węzłów macierze nie uciekają do dużych wartości
+        auto& transformSystem = scene.getTransformSystem();
+        for (EntityID id : ids)
+        {
+            transformSystem.translateEntity(id, glm::vec3(unit(rng), unit(rng), unit(rng)) * 0.1f);
+            transformSystem.rotateEntity(id, glm::normalize(glm::quat(8.0f, unit(rng), unit(rng), unit(rng))));
+        }
+        transformSystem.update();
+        return ids;
+    }
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // błąd względny do największego elementu wzorca, jak w TransformKernelsTest
+    float maxError(const glm::mat4& actual, const glm::mat4& expected)
+    {
+        float magnitude = 1.0f;
+        float error = 0.0f;
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                magnitude = std::max(magnitude, std::abs(expected[column][row]));
+                error = std::max(error, std::abs(actual[column][row] - expected[column][row]));
+            }
+        }
+        return error / magnitude;
+    }
+
+    bool run(Shape shape, uint32_t nodeCount)
+    {
+        Scene scene(nullptr);
+        std::vector<EntityID> ids = buildHierarchy(scene, shape, nodeCount);
+        const Scene& constScene = scene;
+        auto& transformSystem = scene.getTransformSystem();
+        EntityID root = scene.getSceneRootEntity();
+
+        uint32_t maxIndex = entityIndex(root);
+        for (EntityID id : ids)
+        {
+            maxIndex = std::max(maxIndex, entityIndex(id));
+        }
+        std::vector<glm::mat4> reference(maxIndex + 1);
+        double recursive = 1e30;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            auto start = Clock::now();
+            recursiveUpdate(constScene, root, reference);
+            recursive = std::min(recursive, millisecondsSince(start));
+        }
+
+        // całe drzewo brudne - tyle pracy co w przejściu rekurencyjnym
+        double full = 1e30;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            transformSystem.markDirty(root);
+            auto start = Clock::now();
+            transformSystem.update();
+            full = std::min(full, millisecondsSince(start));
+        }
+
+        // typowa klatka: ruszane 1% węzłów (z poddrzewami)
+        double partial = 1e30;
+        for (int repeat = 0; repeat < REPEATS; repeat++)
+        {
+            for (size_t i = repeat; i < ids.size(); i += 100)
+            {
+                transformSystem.markDirty(ids[i]);
+            }
+            auto start = Clock::now();
+            transformSystem.update();
+            partial = std::min(partial, millisecondsSince(start));
+        }
+
+        recursiveUpdate(constScene, root, reference);
+        float worst = 0.0f;
+        for (EntityID id : ids)
+        {
+            worst = std::max(worst, maxError(constScene.getComponent<Transform>(id).globalMatrix, reference[entityIndex(id)]));
+        }
+        bool matches = worst < 1e-4f;
+
+        std::printf("%-5s %7u %12.3f %12.3f %12.3f %10.2fx   max error %.2g%s\n",
+            shape == Shape::Deep ? "deep" : "wide", nodeCount, recursive, full, partial, recursive / full,
+            worst, matches ? "" : "  MISMATCH");
+        return matches;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t threads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 1;
+    JobSystem::GetInstance().setThreadCount(threads);
+
+    std::printf("JobSystem threads: %u, best of %d, ms\n", threads, REPEATS);
+    std::printf("%-5s %7s %12s %12s %12s %11s\n", "shape", "nodes", "recursive", "flat full", "flat 1%", "speedup");
+
+    bool ok = true;
+    for (Shape shape : { Shape::Deep, Shape::Wide })
+    {
+        for (uint32_t nodeCount : { 10000u, 30000u, 100000u })
+        {
+            ok &= run(shape, nodeCount);
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// Porównanie TransformKernels (SSE i skalarnych) z formułą glm używaną wcześniej w TransformSystem:
+// local = translate * mat4_cast * scale, global = parent * local.
+
+#include "ECS/TransformKernels.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace {
+
+    constexpr float TOLERANCE = 1e-5f;
+
+    int failures = 0;
+
+    glm::mat4 referenceLocal(const Transform& transform)
+    {
+        return glm::translate(glm::mat4(1.0f), transform.translation) * glm::mat4_cast(transform.rotation) *
+            glm::scale(glm::mat4(1.0f), transform.scale);
+    }
+
+    // błąd względny do największego elementu wzorca - translacje są o rzędy większe niż elementy obrotu
+    float maxError(const glm::mat4& actual, const glm::mat4& expected)
+    {
+        float magnitude = 1.0f;
+        float error = 0.0f;
+        for (int column = 0; column < 4; column++)
+        {
+            for (int row = 0; row < 4; row++)
+            {
+                magnitude = std::max(magnitude, std::abs(expected[column][row]));
+                error = std::max(error, std::abs(actual[column][row] - expected[column][row]));
+            }
+        }
+        return error / magnitude;
+    }
+
+    void check(bool condition, const char* what, size_t count, size_t index, float error)
+    {
+        if (condition)
+            return;
+        failures++;
+        std::printf("FAIL %s: count %zu, matrix %zu, error %g\n", what, count, index, error);
+    }
+
+    Transform randomTransform(std::mt19937& rng)
+    {
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> scale(0.05f, 8.0f);
+
+        Transform transform;
+        transform.translation = { position(rng), position(rng), position(rng) };
+        transform.rotation = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+        // skala niejednorodna, czasem ujemna (odbicie)
+        transform.scale = { scale(rng), scale(rng), scale(rng) * (unit(rng) < -0.8f ? -1.0f : 1.0f) };
+        return transform;
+    }
+
+    void testCount(std::mt19937& rng, size_t count)
+    {
+        // więcej transformów niż indeksów, indeksy rozrzucone - kernel zbiera dane spod dowolnych pozycji
+        std::vector<Transform> transforms(count * 2 + 1);
+        for (auto& transform : transforms)
+        {
+            transform = randomTransform(rng);
+        }
+        transforms[0].rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        transforms[0].scale = glm::vec3(1.0f);
+
+        std::vector<uint32_t> indices(count);
+        for (size_t i = 0; i < count; i++)
+        {
+            indices[i] = static_cast<uint32_t>((i * 7 + 3) % transforms.size());
+        }
+        indices[0] = 0;
+
+        // kanarek za końcem - wersja SSE nie może pisać poza count macierzy
+        const glm::mat4 canary(-12345.0f);
+        std::vector<glm::mat4> simd(count + 1, canary);
+        std::vector<glm::mat4> scalar(count + 1, canary);
+        TransformKernels::composeLocalMatrices(transforms.data(), indices, simd.data());
+        TransformKernels::composeLocalMatricesScalar(transforms.data(), indices, scalar.data());
+        check(simd[count] == canary, "composeLocalMatrices wrote past the end", count, count, 0.0f);
+        check(scalar[count] == canary, "composeLocalMatricesScalar wrote past the end", count, count, 0.0f);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const Transform& transform = transforms[indices[i]];
+            glm::mat4 expected = referenceLocal(transform);
+
+            float error = maxError(simd[i], expected);
+            check(error <= TOLERANCE, "composeLocalMatrices", count, i, error);
+            error = maxError(scalar[i], expected);
+            check(error <= TOLERANCE, "composeLocalMatricesScalar", count, i, error);
+
+            glm::mat4 parent = referenceLocal(randomTransform(rng));
+            glm::mat4 expectedGlobal = parent * expected;
+            error = maxError(TransformKernels::multiplyAffine(parent, simd[i]), expectedGlobal);
+            check(error <= TOLERANCE, "multiplyAffine", count, i, error);
+            error = maxError(TransformKernels::multiplyAffineScalar(parent, scalar[i]), expectedGlobal);
+            check(error <= TOLERANCE, "multiplyAffineScalar", count, i, error);
+        }
+    }
+
+}
+
+int main()
+{
+#ifdef PBL_TRANSFORM_SSE
+    std::printf("TransformKernels: SSE path\n");
+#else
+    std::printf("TransformKernels: scalar path only\n");
+#endif
+
+    std::mt19937 rng(2025);
+    // liczby niepodzielne przez 4 - ogon po grupach SSE
+    for (size_t count : { 1, 2, 3, 4, 5, 7, 8, 9, 63, 1003 })
+    {
+        testCount(rng, count);
+    }
+
+    if (failures > 0)
+    {
+        std::printf("%d checks failed\n", failures);
+        return 1;
+    }
+    std::printf("all checks passed\n");
+    return 0;
+}
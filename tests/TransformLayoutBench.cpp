@@ -0,0 +1,162 @@
+// Układ Transform: gorąca część (Transform + osobny TransformInfoComponent) kontra dawny Transform
+// z dziećmi, kątami Eulera i uuid w tej samej strukturze. Te same dane i ten sam kod w obu układach:
+// przejście liniowe (odczyt jak w systemach gry) i przeliczenie macierzy globalnych w kolejności rodzic -> dziecko.
+// Wyniki przeliczenia porównywane bit po bicie - przy różnicy kod wyjścia 1.
+// Użycie: TransformLayoutBench [liczba węzłów, domyślnie 100000]
+
+#include "Components.h"
+
+#include <glm/gtc/quaternion.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Transform sprzed podziału na część gorącą i zimną
+    struct LegacyTransform {
+        bool isStatic = true;
+
+        glm::vec3 translation = { 0.0f, 0.0f, 0.0f };
+        glm::quat rotation = { 1.0f, 0.0f, 0.0f, 0.0f };
+        glm::vec3 eulerRotation = glm::vec3(0.0f);
+        glm::vec3 scale = { 1.0f, 1.0f, 1.0f };
+        glm::mat4 globalMatrix = glm::mat4(1.0f);
+
+        bool isDirty = true;
+        std::vector<EntityID> children;
+        EntityID parent = (EntityID)-1;
+
+        std::string uuid;
+
+        EntityID id = (EntityID)-1;
+    };
+
+    // parent to tutaj pozycja rodzica w tablicy, zawsze przed dzieckiem
+    template<typename T>
+    void propagate(std::vector<T>& transforms)
+    {
+        for (T& transform : transforms)
+        {
+            glm::mat4 local = glm::mat4_cast(transform.rotation);
+            local[0] *= transform.scale.x;
+            local[1] *= transform.scale.y;
+            local[2] *= transform.scale.z;
+            local[3] = glm::vec4(transform.translation, 1.0f);
+            transform.globalMatrix = transform.parent == (EntityID)-1
+                ? local
+                : transforms[transform.parent].globalMatrix * local;
+        }
+    }
+
+    template<typename T>
+    float scan(const std::vector<T>& transforms)
+    {
+        float sum = 0.0f;
+        for (const T& transform : transforms)
+        {
+            sum += transform.translation.x + transform.globalMatrix[3].y;
+        }
+        return sum;
+    }
+
+    template<typename Body>
+    double bestMilliseconds(int repeats, Body&& body)
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < repeats; repeat++)
+        {
+            auto start = Clock::now();
+            body();
+            best = std::min(best, std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        }
+        return best;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t nodeCount = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 100000;
+
+    // las poddrzew losowej wielkości (1..1024 węzłów), losowy rodzic wewnątrz poddrzewa
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<Transform> hot;
+    std::vector<TransformInfoComponent> cold;
+    std::vector<LegacyTransform> legacy;
+    hot.reserve(nodeCount);
+    cold.reserve(nodeCount);
+    legacy.reserve(nodeCount);
+    while (hot.size() < nodeCount)
+    {
+        uint32_t top = static_cast<uint32_t>(hot.size());
+        uint32_t subtreeSize = 1u << (rng() % 11);
+        for (uint32_t k = 0; k < subtreeSize && hot.size() < nodeCount; k++)
+        {
+            uint32_t index = static_cast<uint32_t>(hot.size());
+            EntityID parent = k == 0 ? (EntityID)-1 : top + rng() % k;
+
+            Transform transform;
+            transform.translation = { unit(rng), unit(rng), unit(rng) };
+            transform.rotation = glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+            transform.scale = glm::vec3(1.0f + 0.1f * unit(rng));
+            transform.parent = parent;
+            transform.id = index;
+            hot.push_back(transform);
+
+            TransformInfoComponent info;
+            info.eulerRotation = glm::eulerAngles(transform.rotation);
+            info.id = index;
+            cold.push_back(info);
+
+            LegacyTransform old;
+            old.translation = transform.translation;
+            old.rotation = transform.rotation;
+            old.eulerRotation = info.eulerRotation;
+            old.scale = transform.scale;
+            old.parent = parent;
+            old.uuid = "00000000-0000-0000-0000-000000000000";
+            old.id = index;
+            legacy.push_back(std::move(old));
+
+            if (parent != (EntityID)-1)
+            {
+                cold[parent].children.push_back(index);
+                legacy[parent].children.push_back(index);
+            }
+        }
+    }
+
+    std::printf("%u nodes, hardware threads: %u, best of 10\n", nodeCount, std::thread::hardware_concurrency());
+    std::printf("sizeof(Transform) = %zu, sizeof(TransformInfoComponent) = %zu, sizeof(pre-split Transform) = %zu\n",
+        sizeof(Transform), sizeof(TransformInfoComponent), sizeof(LegacyTransform));
+
+    volatile float sink = 0.0f;
+    double hotPropagate = bestMilliseconds(10, [&]() { propagate(hot); });
+    double legacyPropagate = bestMilliseconds(10, [&]() { propagate(legacy); });
+    double hotScan = bestMilliseconds(10, [&]() { sink = sink + scan(hot); });
+    double legacyScan = bestMilliseconds(10, [&]() { sink = sink + scan(legacy); });
+
+    bool identical = true;
+    for (uint32_t i = 0; i < nodeCount; i++)
+    {
+        identical &= std::memcmp(&hot[i].globalMatrix, &legacy[i].globalMatrix, sizeof(glm::mat4)) == 0;
+    }
+
+    std::printf("%-38s %10s %12s %8s\n", "", "hot/cold", "pre-split", "ratio");
+    std::printf("%-38s %10.3f %12.3f %7.2fx\n", "propagate global matrices, ms", hotPropagate, legacyPropagate,
+        legacyPropagate / hotPropagate);
+    std::printf("%-38s %10.3f %12.3f %7.2fx\n", "linear scan (translation, matrix), ms", hotScan, legacyScan,
+        legacyScan / hotScan);
+    std::printf("same matrices: %s\n", identical ? "yes" : "NO");
+    return identical ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// TransformSystem::update() na wielu wątkach JobSystem daje te same macierze, bit w bit,
+// co na jednym wątku - przy pełnym przeliczeniu, poddrzewach oznaczonych w klatce i po przepięciach.
+
+#include "TestCheck.h"
+
+#include "JobSystem.h"
+#include "Scene.h"
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    // powyżej PARALLEL_MIN_NODES, żeby ścieżka równoległa faktycznie była używana
+    constexpr uint32_t NODE_COUNT = 20000;
+    constexpr int FRAMES = 6;
+
+    // wszystkie klatki sceny: po każdym update() macierze globalne w kolejności tworzenia encji
+    std::vector<glm::mat4> simulate(uint32_t threads)
+    {
+        JobSystem::GetInstance().setThreadCount(threads);
+
+        Scene scene(nullptr);
+        auto& transformSystem = scene.getTransformSystem();
+        std::mt19937 rng(5);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        // poddrzewa różnej wielkości pod korzeniem sceny, jak w scenach poziomów, plus kilka długich łańcuchów
+        std::vector<EntityID> ids;
+        std::vector<EntityID> tops;
+        while (ids.size() < NODE_COUNT)
+        {
+            EntityID top = scene.createEntity(scene.getSceneRootEntity());
+            ids.push_back(top);
+            tops.push_back(top);
+            uint32_t size = 1u << (rng() % 10);
+            bool chain = rng() % 8 == 0;
+            std::vector<EntityID> local{ top };
+            for (uint32_t k = 0; k < size && ids.size() < NODE_COUNT; k++)
+            {
+                EntityID parent = chain ? local.back() : local[rng() % local.size()];
+                EntityID id = scene.createEntity(parent);
+                local.push_back(id);
+                ids.push_back(id);
+            }
+        }
+        for (EntityID id : ids)
+        {
+            transformSystem.translateEntity(id, glm::vec3(unit(rng), unit(rng), unit(rng)));
+            transformSystem.rotateEntity(id, glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng))));
+            transformSystem.scaleEntity(id, glm::vec3(1.0f + 0.2f * unit(rng)));
+        }
+
+        std::vector<glm::mat4> frames;
+        auto record = [&]()
+            {
+                transformSystem.update();
+                for (EntityID id : ids)
+                {
+                    frames.push_back(std::as_const(scene).getComponent<Transform>(id).globalMatrix);
+                }
+            };
+
+        record();
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            // cała scena, co czwarta klatka
+            if (frame % 4 == 0)
+                transformSystem.markDirty(scene.getSceneRootEntity());
+
+            // ruch korzeni poddrzew - dużo węzłów, poziomy dzielone na zadania
+            for (size_t i = frame; i < tops.size(); i += 2)
+            {
+                transformSystem.translateEntity(tops[i], glm::vec3(float(frame), unit(rng), 0.0f));
+            }
+            // przepięcia w środku grafu
+            for (int k = 0; k < 20; k++)
+            {
+                EntityID child = ids[rng() % ids.size()];
+                EntityID parent = tops[rng() % tops.size()];
+                if (child != parent)
+                    transformSystem.addChild(parent, child);
+            }
+            record();
+        }
+        return frames;
+    }
+
+}
+
+int main()
+{
+    std::vector<glm::mat4> serial = simulate(1);
+    for (uint32_t threads : { 2u, 4u, 8u })
+    {
+        std::vector<glm::mat4> parallel = simulate(threads);
+        CHECK(parallel.size() == serial.size());
+        CHECK(parallel.size() == serial.size() &&
+            std::memcmp(parallel.data(), serial.data(), serial.size() * sizeof(glm::mat4)) == 0);
+    }
+    return TestCheck::finish();
+}
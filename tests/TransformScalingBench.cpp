@@ -0,0 +1,181 @@
+// Skalowanie TransformSystem::update() od 1 do N wątków JobSystem i dane, z których wybrano
+// PARALLEL_MIN_NODES i PARALLEL_BATCH (TransformSystem.h):
+//  1. koszt pustego parallelFor - płacony raz na poziom głębokości,
+//  2. ns/węzeł na 1 wątku i na N wątkach przy 1k-64k przeliczanych węzłach; "extra CPU" to o ile więcej
+//     kosztuje ścieżka równoległa - na jednym rdzeniu czas ściany to łączny czas CPU wszystkich wątków,
+//  3. scena 100k węzłów (~300 poddrzew pod korzeniem) na 1, 2, 4, 8 wątkach + zgodność bit w bit z 1 wątkiem.
+// Inne progi mierzy się po zmianie stałych w TransformSystem.h i ponownym uruchomieniu.
+// Użycie: TransformScalingBench [maksymalna liczba wątków, domyślnie 8]
+
+#include "JobSystem.h"
+#include "Scene.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    struct SyntheticScene {
+        Scene scene{ nullptr };
+        std::vector<EntityID> ids;
+        std::vector<EntityID> tops;
+        uint32_t levels = 0;
+    };
+
+    // poddrzewa o losowej wielkości (do maxSubtree węzłów) pod korzeniem sceny
+    void buildScene(SyntheticScene& target, uint32_t nodeCount, uint32_t maxSubtree)
+    {
+        Scene& scene = target.scene;
+        auto& transformSystem = scene.getTransformSystem();
+        std::mt19937 rng(7);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+
+        std::vector<uint32_t> depth;
+        while (target.ids.size() < nodeCount)
+        {
+            EntityID top = scene.createEntity(scene.getSceneRootEntity());
+            target.ids.push_back(top);
+            target.tops.push_back(top);
+            std::vector<EntityID> local{ top };
+            depth.assign(1, 1);
+            uint32_t size = rng() % maxSubtree;
+            for (uint32_t k = 0; k < size && target.ids.size() < nodeCount; k++)
+            {
+                uint32_t parent = rng() % local.size();
+                local.push_back(scene.createEntity(local[parent]));
+                depth.push_back(depth[parent] + 1);
+                target.ids.push_back(local.back());
+                target.levels = std::max(target.levels, depth.back());
+            }
+        }
+        for (EntityID id : target.ids)
+        {
+            transformSystem.translateEntity(id, glm::vec3(unit(rng), unit(rng), unit(rng)));
+            transformSystem.rotateEntity(id, glm::normalize(glm::quat(unit(rng), unit(rng), unit(rng), unit(rng))));
+        }
+        transformSystem.update();
+    }
+
+    // ms na klatkę, w której wszystkie węzły są przeliczane; najlepsze z 9 powtórzeń
+    double fullFrame(uint32_t threads, uint32_t nodeCount, uint32_t maxSubtree, uint32_t& levels)
+    {
+        JobSystem::GetInstance().setThreadCount(threads);
+        SyntheticScene synthetic;
+        buildScene(synthetic, nodeCount, maxSubtree);
+        levels = synthetic.levels;
+
+        auto& transformSystem = synthetic.scene.getTransformSystem();
+        int frames = std::max(5u, 400000u / nodeCount);
+        double best = 1e30;
+        for (int repeat = 0; repeat < 9; repeat++)
+        {
+            auto start = Clock::now();
+            for (int frame = 0; frame < frames; frame++)
+            {
+                for (EntityID id : synthetic.ids)
+                {
+                    transformSystem.markDirty(id);
+                }
+                transformSystem.update();
+            }
+            best = std::min(best, millisecondsSince(start) / frames);
+        }
+        return best;
+    }
+
+    // scena 100k: korzenie poddrzew ruszane co klatkę, całe poddrzewa przeliczane
+    std::vector<glm::mat4> largeScene(uint32_t threads, double& milliseconds)
+    {
+        JobSystem::GetInstance().setThreadCount(threads);
+        SyntheticScene synthetic;
+        buildScene(synthetic, 100000, 1024);
+
+        auto& transformSystem = synthetic.scene.getTransformSystem();
+        constexpr int FRAMES = 50;
+        auto start = Clock::now();
+        for (int frame = 0; frame < FRAMES; frame++)
+        {
+            for (EntityID id : synthetic.tops)
+            {
+                transformSystem.translateEntity(id, glm::vec3(float(frame), 0.0f, 0.0f));
+            }
+            transformSystem.update();
+        }
+        milliseconds = millisecondsSince(start) / FRAMES;
+
+        std::vector<glm::mat4> result;
+        result.reserve(synthetic.ids.size());
+        for (EntityID id : synthetic.ids)
+        {
+            result.push_back(std::as_const(synthetic.scene).getComponent<Transform>(id).globalMatrix);
+        }
+        return result;
+    }
+
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t maxThreads = argc > 1 ? static_cast<uint32_t>(std::atoi(argv[1])) : 8;
+    std::printf("hardware threads: %u\n\n", std::thread::hardware_concurrency());
+
+    JobSystem& jobSystem = JobSystem::GetInstance();
+    jobSystem.setThreadCount(maxThreads);
+    volatile uint32_t sink = 0;
+    for (uint32_t jobs : { 4u, 8u, 16u })
+    {
+        double best = 1e30;
+        for (int repeat = 0; repeat < 5; repeat++)
+        {
+            auto start = Clock::now();
+            for (int call = 0; call < 200; call++)
+            {
+                jobSystem.parallelFor(jobs * 64, 64, [&](uint32_t begin, uint32_t end) { sink = sink + (end - begin); });
+            }
+            best = std::min(best, millisecondsSince(start) * 1e6 / 200);
+        }
+        std::printf("parallelFor, %u threads, %2u jobs: %7.0f ns/call, %5.0f ns/job\n", maxThreads, jobs, best, best / jobs);
+    }
+
+    std::printf("\n%7s %8s %7s %12s %12s %10s\n", "nodes", "subtree", "levels", "1 thr ns/n", "N thr ns/n", "extra CPU");
+    for (uint32_t maxSubtree : { 64u, 1024u })
+    {
+        for (uint32_t nodeCount : { 1024u, 2048u, 4096u, 8192u, 16384u, 65536u })
+        {
+            uint32_t levels = 0;
+            double serial = fullFrame(1, nodeCount, maxSubtree, levels);
+            double parallel = fullFrame(maxThreads, nodeCount, maxSubtree, levels);
+            std::printf("%7u %8u %7u %12.1f %12.1f %9.0f%%\n", nodeCount, maxSubtree, levels,
+                serial * 1e6 / nodeCount, parallel * 1e6 / nodeCount, (parallel / serial - 1.0) * 100.0);
+        }
+    }
+
+    std::printf("\n100k nodes, subtree roots moved every frame\n");
+    double milliseconds = 0.0;
+    std::vector<glm::mat4> reference = largeScene(1, milliseconds);
+    std::printf("threads %u: %8.3f ms/frame\n", 1u, milliseconds);
+    bool identical = true;
+    for (uint32_t threads = 2; threads <= maxThreads; threads *= 2)
+    {
+        std::vector<glm::mat4> result = largeScene(threads, milliseconds);
+        bool same = result.size() == reference.size() &&
+            std::memcmp(result.data(), reference.data(), reference.size() * sizeof(glm::mat4)) == 0;
+        identical &= same;
+        std::printf("threads %u: %8.3f ms/frame, identical %s\n", threads, milliseconds, same ? "yes" : "NO");
+    }
+    return identical ? 0 : 1;
+}